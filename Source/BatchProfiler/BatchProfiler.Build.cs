@@ -15,6 +15,10 @@ public class BatchProfiler : ModuleRules
 				, "CoreUObject"
 				, "Engine"
 				, "InputCore"
+				, "RHI"
+				, "RenderCore"
+				, "Json"
+				, "JsonUtilities"
 			}
 		);
 		
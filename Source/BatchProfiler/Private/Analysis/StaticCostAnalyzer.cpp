@@ -0,0 +1,356 @@
+#include "Analysis/StaticCostAnalyzer.h"
+#include "Utilities/ProfilerStats.h"
+#include "ProfilingCamera.h"
+#include "Async/ParallelFor.h"
+#include "Camera/CameraComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/LightComponent.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/SkinnedAsset.h"
+#include "Engine/StaticMesh.h"
+#include "Kismet/GameplayStatics.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "SceneManagement.h"
+#include "StaticMeshResources.h"
+#include "UObject/UObjectIterator.h"
+#include "Utilities/Utilities.h"
+
+/**
+ * @brief Caches every primitive and shadow casting light in the world so cameras can be analyzed without touching UObjects
+ * @param World World to analyze
+ */
+FStaticCostAnalyzer::FStaticCostAnalyzer(const UWorld* World)
+{
+	CachePrimitives(World);
+	CacheLights(World);
+}
+
+#pragma region Caching
+void FStaticCostAnalyzer::CachePrimitives(const UWorld* World)
+{
+	for (TObjectIterator<UPrimitiveComponent> It; It; ++It)
+	{
+		const UPrimitiveComponent* Primitive = *It;
+		const AActor* Owner = Primitive->GetOwner();
+		if (Primitive->GetWorld() != World || !Primitive->IsRegistered() || !Primitive->IsVisible() || Primitive->bHiddenInGame)
+		{
+			continue;
+		}
+
+		if (Owner == nullptr || Owner->IsHidden() || Primitive->IsEditorOnly())
+		{
+			continue;
+		}
+
+		FPrimitiveEntry Entry;
+		Entry.Name = Owner->GetName() + TEXT(".") + Primitive->GetName();
+		Entry.Origin = Primitive->Bounds.Origin;
+		Entry.BoxExtent = Primitive->Bounds.BoxExtent;
+		Entry.SphereRadius = Primitive->Bounds.SphereRadius;
+		Entry.MaxDrawDistance = Primitive->CachedMaxDrawDistance;
+		Entry.Materials = Primitive->GetNumMaterials();
+		Entry.bCastsDynamicShadow = Primitive->CastShadow && Primitive->bCastDynamicShadow;
+
+		if (const UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Primitive))
+		{
+			const UStaticMesh* StaticMesh = StaticMeshComponent->GetStaticMesh();
+			const FStaticMeshRenderData* RenderData = StaticMesh ? StaticMesh->GetRenderData() : nullptr;
+			if (RenderData == nullptr)
+			{
+				continue;
+			}
+
+			Entry.AssetName = StaticMesh->GetName();
+			Entry.ForcedLODIndex = StaticMeshComponent->ForcedLodModel - 1;
+			for (int32 LODIndex = 0; LODIndex < RenderData->LODResources.Num(); ++LODIndex)
+			{
+				Entry.LODScreenSizes.Add(RenderData->ScreenSize[LODIndex].GetValue());
+				Entry.LODTriangles.Add(RenderData->LODResources[LODIndex].GetNumTriangles());
+				Entry.LODSections.Add(RenderData->LODResources[LODIndex].Sections.Num());
+			}
+
+			if (const UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Primitive))
+			{
+				// Component bounds enclose every instance, they would select one LOD for all of them
+				const FBoxSphereBounds MeshBounds = StaticMesh->GetBounds();
+				Entry.InstanceBounds.Reserve(InstancedComponent->GetInstanceCount());
+				for (int32 InstanceIndex = 0; InstanceIndex < InstancedComponent->GetInstanceCount(); ++InstanceIndex)
+				{
+					FTransform InstanceTransform;
+					if (InstancedComponent->GetInstanceTransform(InstanceIndex, InstanceTransform, true))
+					{
+						Entry.InstanceBounds.Add(MeshBounds.TransformBy(InstanceTransform));
+					}
+				}
+
+				if (InstancedComponent->InstanceEndCullDistance > 0)
+				{
+					const float EndCullDistance = static_cast<float>(InstancedComponent->InstanceEndCullDistance);
+					Entry.MaxDrawDistance = Entry.MaxDrawDistance > 0.f ? FMath::Min(Entry.MaxDrawDistance, EndCullDistance) : EndCullDistance;
+				}
+			}
+		}
+		else if (const USkinnedMeshComponent* SkinnedComponent = Cast<USkinnedMeshComponent>(Primitive))
+		{
+			const USkinnedAsset* SkinnedAsset = SkinnedComponent->GetSkinnedAsset();
+			const FSkeletalMeshRenderData* RenderData = SkinnedComponent->GetSkeletalMeshRenderData();
+			if (SkinnedAsset == nullptr || RenderData == nullptr)
+			{
+				continue;
+			}
+
+			Entry.AssetName = SkinnedAsset->GetName();
+			Entry.ForcedLODIndex = SkinnedComponent->GetForcedLOD() - 1;
+			for (int32 LODIndex = 0; LODIndex < RenderData->LODRenderData.Num(); ++LODIndex)
+			{
+				const FSkeletalMeshLODInfo* LODInfo = SkinnedAsset->GetLODInfo(LODIndex);
+				Entry.LODScreenSizes.Add(LODInfo ? LODInfo->ScreenSize.GetValue() : 0.f);
+				Entry.LODTriangles.Add(RenderData->LODRenderData[LODIndex].GetTotalFaces());
+				Entry.LODSections.Add(RenderData->LODRenderData[LODIndex].RenderSections.Num());
+			}
+		}
+
+		Primitives.Add(MoveTemp(Entry));
+	}
+}
+
+void FStaticCostAnalyzer::CacheLights(const UWorld* World)
+{
+	for (TObjectIterator<ULightComponent> It; It; ++It)
+	{
+		const ULightComponent* Light = *It;
+		if (Light->GetWorld() != World || !Light->IsRegistered() || !Light->IsVisible())
+		{
+			continue;
+		}
+
+		// Static lights are baked and never render dynamic shadows
+		if (!Light->CastShadows || !Light->CastDynamicShadows || Light->Mobility == EComponentMobility::Static || Light->Intensity <= 0.f)
+		{
+			continue;
+		}
+
+		FLightEntry Entry;
+		Entry.Bounds = Light->GetBoundingSphere();
+		Entry.bIsDirectional = Light->GetLightType() == LightType_Directional;
+		Lights.Add(Entry);
+	}
+}
+#pragma endregion
+
+#pragma region Analysis
+/**
+ * @brief Estimates the render cost of each camera frustum
+ * @param Cameras Cameras to analyze
+ * @param TopCount Amount of heaviest primitives to keep per camera
+ * @return Report per camera
+ */
+TArray<FStaticCostReport> FStaticCostAnalyzer::Analyze(const TArray<AProfilingCamera*>& Cameras, const int32 TopCount) const
+{
+	BATCHPROFILER_SCOPE(StaticCostAnalyze);
+	// Gather camera views on game thread, the rest only reads cached data
+	TArray<FMinimalViewInfo> Views;
+	TArray<FStaticCostReport> Reports;
+	for (AProfilingCamera* Camera : Cameras)
+	{
+		FMinimalViewInfo ViewInfo;
+		Camera->GetCameraComponent()->GetCameraView(0.f, ViewInfo);
+		Views.Add(ViewInfo);
+
+		FStaticCostReport& Report = Reports.AddDefaulted_GetRef();
+		Report.CameraName = Camera->CameraName;
+	}
+
+	ParallelFor(Views.Num(), [this, &Views, &Reports, TopCount](const int32 CameraIndex)
+	{
+		const FMinimalViewInfo& ViewInfo = Views[CameraIndex];
+		FStaticCostReport& Report = Reports[CameraIndex];
+
+		FMatrix ViewMatrix;
+		FMatrix ProjectionMatrix;
+		FMatrix ViewProjectionMatrix;
+		UGameplayStatics::GetViewProjectionMatrix(ViewInfo, ViewMatrix, ProjectionMatrix, ViewProjectionMatrix);
+
+		FConvexVolume Frustum;
+		GetViewFrustumBounds(Frustum, ViewProjectionMatrix, false);
+
+		// Same screen size metric the engine uses for LOD selection
+		const float ScreenMultiple = FMath::Max(0.5f * ProjectionMatrix.M[0][0], 0.5f * ProjectionMatrix.M[1][1]);
+
+		TArray<FStaticCostPrimitive> VisiblePrimitives;
+		for (const FPrimitiveEntry& Primitive : Primitives)
+		{
+			// Component bounds enclose all instances, instanced meshes are only culled as a whole here
+			float ScreenRadiusSquared;
+			const FBoxSphereBounds PrimitiveBounds(Primitive.Origin, Primitive.BoxExtent, Primitive.SphereRadius);
+			if (!IsBoundsVisible(Primitive, PrimitiveBounds, ViewInfo, Frustum, ScreenMultiple, ScreenRadiusSquared))
+			{
+				continue;
+			}
+
+			FStaticCostPrimitive Cost;
+			Cost.Name = Primitive.Name;
+			Cost.AssetName = Primitive.AssetName;
+			Cost.Materials = Primitive.Materials;
+			Cost.LODIndex = INDEX_NONE;
+			Cost.Instances = 0;
+
+			// Instanced meshes draw each section once per LOD in use
+			uint32 UsedLODs = 0;
+			float Coverage = 0.f;
+			const auto AddInstance = [&Primitive, &Cost, &UsedLODs, &Coverage](const float InstanceScreenRadiusSquared)
+			{
+				const int32 LODIndex = SelectLOD(Primitive, InstanceScreenRadiusSquared);
+				Cost.LODIndex = Cost.LODIndex == INDEX_NONE ? LODIndex : FMath::Min(Cost.LODIndex, LODIndex);
+				Cost.Instances++;
+				Cost.Triangles += Primitive.LODTriangles.IsValidIndex(LODIndex) ? Primitive.LODTriangles[LODIndex] : 0;
+				Cost.ScreenSize = FMath::Max(Cost.ScreenSize, 2.f * FMath::Sqrt(InstanceScreenRadiusSquared));
+				Coverage += FMath::Min(1.f, PI * InstanceScreenRadiusSquared);
+
+				if (LODIndex < 32 && (UsedLODs & (1u << LODIndex)) == 0)
+				{
+					UsedLODs |= 1u << LODIndex;
+					Cost.Sections += Primitive.LODSections.IsValidIndex(LODIndex) ? Primitive.LODSections[LODIndex] : 0;
+				}
+			};
+
+			if (Primitive.InstanceBounds.Num() == 0)
+			{
+				AddInstance(ScreenRadiusSquared);
+			}
+			else
+			{
+				for (const FBoxSphereBounds& InstanceBounds : Primitive.InstanceBounds)
+				{
+					float InstanceScreenRadiusSquared;
+					if (IsBoundsVisible(Primitive, InstanceBounds, ViewInfo, Frustum, ScreenMultiple, InstanceScreenRadiusSquared))
+					{
+						AddInstance(InstanceScreenRadiusSquared);
+					}
+				}
+			}
+
+			if (Cost.Instances == 0)
+			{
+				continue;
+			}
+
+			Report.Triangles += Cost.Triangles;
+			Report.Sections += Cost.Sections;
+			Report.Materials += Cost.Materials;
+			Report.SummedPrimitiveCoverage += Coverage;
+			Report.DynamicShadowCasters += Primitive.bCastsDynamicShadow ? 1 : 0;
+			VisiblePrimitives.Add(MoveTemp(Cost));
+		}
+
+		for (const FLightEntry& Light : Lights)
+		{
+			if (Light.bIsDirectional || Frustum.IntersectSphere(Light.Bounds.Center, Light.Bounds.W))
+			{
+				Report.ShadowCastingLights++;
+			}
+		}
+
+		// Sort by triangles, then by name so reports stay diffable across builds
+		VisiblePrimitives.Sort([](const FStaticCostPrimitive& A, const FStaticCostPrimitive& B)
+		{
+			return A.Triangles != B.Triangles ? A.Triangles > B.Triangles : A.Name < B.Name;
+		});
+
+		Report.VisiblePrimitives = VisiblePrimitives.Num();
+		Report.TopPrimitives.Append(VisiblePrimitives.GetData(), FMath::Min(TopCount, VisiblePrimitives.Num()));
+	});
+
+	Reports.Sort([](const FStaticCostReport& A, const FStaticCostReport& B)
+	{
+		return A.CameraName < B.CameraName;
+	});
+
+	return Reports;
+}
+
+/**
+ * @brief Culls bounds by draw distance and frustum and measures their screen radius
+ * @param Primitive Cached primitive
+ * @param Bounds Bounds of the primitive or of one of its instances
+ * @param ViewInfo Camera view
+ * @param Frustum Camera frustum
+ * @param ScreenMultiple Screen size multiplier of the projection
+ * @param OutScreenRadiusSquared Squared screen radius of the bounds
+ * @return If the bounds are rendered
+ */
+bool FStaticCostAnalyzer::IsBoundsVisible(const FPrimitiveEntry& Primitive, const FBoxSphereBounds& Bounds, const FMinimalViewInfo& ViewInfo, const FConvexVolume& Frustum,
+	const float ScreenMultiple, float& OutScreenRadiusSquared)
+{
+	const float DistanceSquared = FVector::DistSquared(Bounds.Origin, ViewInfo.Location);
+	if (Primitive.MaxDrawDistance > 0.f && DistanceSquared > FMath::Square(Primitive.MaxDrawDistance + Bounds.SphereRadius))
+	{
+		return false;
+	}
+
+	if (!Frustum.IntersectBox(Bounds.Origin, Bounds.BoxExtent))
+	{
+		return false;
+	}
+
+	OutScreenRadiusSquared = FMath::Square(ScreenMultiple * Bounds.SphereRadius) / FMath::Max(1.f, DistanceSquared);
+	return true;
+}
+
+/**
+ * @brief Selects the LOD the engine would render for the given screen radius
+ * @param Primitive Cached primitive
+ * @param ScreenRadiusSquared Squared screen radius of primitive bounds
+ * @return LOD index
+ */
+int32 FStaticCostAnalyzer::SelectLOD(const FPrimitiveEntry& Primitive, const float ScreenRadiusSquared)
+{
+	const int32 NumLODs = Primitive.LODScreenSizes.Num();
+	if (Primitive.ForcedLODIndex >= 0)
+	{
+		return FMath::Min(Primitive.ForcedLODIndex, NumLODs - 1);
+	}
+
+	for (int32 LODIndex = NumLODs - 1; LODIndex >= 0; --LODIndex)
+	{
+		if (FMath::Square(Primitive.LODScreenSizes[LODIndex] * 0.5f) > ScreenRadiusSquared)
+		{
+			return LODIndex;
+		}
+	}
+
+	return 0;
+}
+#pragma endregion
+
+#pragma region Report
+/**
+ * @brief Writes camera totals and the heaviest primitives of each camera as csv
+ * @param Reports Reports to write
+ */
+void FStaticCostAnalyzer::WriteReport(const TArray<FStaticCostReport>& Reports)
+{
+	FString Summary = TEXT("Camera,VisiblePrimitives,Triangles,Materials,Sections,SummedPrimitiveCoverage,ShadowCastingLights,DynamicShadowCasters\n");
+	FString TopPrimitives = TEXT("Camera,Rank,Primitive,Asset,LOD,Instances,Triangles,Materials,Sections,ScreenSize\n");
+
+	for (const FStaticCostReport& Report : Reports)
+	{
+		Summary += FString::Printf(TEXT("%s,%d,%lld,%d,%d,%.3f,%d,%d\n"),
+			*Report.CameraName, Report.VisiblePrimitives, Report.Triangles, Report.Materials, Report.Sections,
+			Report.SummedPrimitiveCoverage, Report.ShadowCastingLights, Report.DynamicShadowCasters);
+
+		for (int32 Rank = 0; Rank < Report.TopPrimitives.Num(); ++Rank)
+		{
+			const FStaticCostPrimitive& Primitive = Report.TopPrimitives[Rank];
+			TopPrimitives += FString::Printf(TEXT("%s,%d,%s,%s,%d,%d,%lld,%d,%d,%.4f\n"),
+				*Report.CameraName, Rank + 1, *Primitive.Name, *Primitive.AssetName, Primitive.LODIndex, Primitive.Instances,
+				Primitive.Triangles, Primitive.Materials, Primitive.Sections, Primitive.ScreenSize);
+		}
+	}
+
+	const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y.%m.%d_%H.%M"));
+	FUtilities::SaveReport(FString::Printf(TEXT("StaticCost_%s.csv"), *Timestamp), Summary);
+	FUtilities::SaveReport(FString::Printf(TEXT("StaticCost_%s_TopPrimitives.csv"), *Timestamp), TopPrimitives);
+}
+#pragma endregion
@@ -0,0 +1,453 @@
+#include "Batch/BatchCheckpoint.h"
+#include "Utilities/ProfilerStats.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Utilities/Utilities.h"
+
+namespace BatchCheckpoint
+{
+	static const TCHAR* InterruptedReason = TEXT("Interrupted");
+
+	static TSharedRef<FJsonObject> SummaryToJson(const FCameraCaptureSummary& Summary)
+	{
+		const FFrameStats& Stats = Summary.FrameStats;
+		const TSharedRef<FJsonObject> FrameStats = MakeShared<FJsonObject>();
+		FrameStats->SetNumberField(TEXT("FrameCount"), Stats.FrameCount);
+		FrameStats->SetNumberField(TEXT("DurationSecs"), Stats.DurationSecs);
+		FrameStats->SetNumberField(TEXT("AvgFrameMs"), Stats.AvgFrameMs);
+		FrameStats->SetNumberField(TEXT("StdDevFrameMs"), Stats.StdDevFrameMs);
+		FrameStats->SetNumberField(TEXT("P95FrameMs"), Stats.P95FrameMs);
+		FrameStats->SetNumberField(TEXT("MaxFrameMs"), Stats.MaxFrameMs);
+		FrameStats->SetNumberField(TEXT("AvgGameThreadMs"), Stats.AvgGameThreadMs);
+		FrameStats->SetNumberField(TEXT("AvgRenderThreadMs"), Stats.AvgRenderThreadMs);
+		FrameStats->SetNumberField(TEXT("AvgGPUMs"), Stats.AvgGPUMs);
+
+		// Metrics are stored as an array to keep their column order
+		TArray<TSharedPtr<FJsonValue>> Metrics;
+		for (const TPair<FString, double>& Metric : Summary.Metrics)
+		{
+			const TSharedRef<FJsonObject> MetricObject = MakeShared<FJsonObject>();
+			MetricObject->SetStringField(TEXT("Name"), Metric.Key);
+			MetricObject->SetNumberField(TEXT("Value"), Metric.Value);
+			Metrics.Add(MakeShared<FJsonValueObject>(MetricObject));
+		}
+
+		const TSharedRef<FJsonObject> SummaryObject = MakeShared<FJsonObject>();
+		SummaryObject->SetStringField(TEXT("Camera"), Summary.CameraName);
+		SummaryObject->SetObjectField(TEXT("FrameStats"), FrameStats);
+		SummaryObject->SetArrayField(TEXT("Metrics"), Metrics);
+		return SummaryObject;
+	}
+
+	static FCameraCaptureSummary SummaryFromJson(const FJsonObject& SummaryObject)
+	{
+		FCameraCaptureSummary Summary;
+		Summary.CameraName = SummaryObject.GetStringField(TEXT("Camera"));
+
+		const TSharedPtr<FJsonObject>* FrameStatsObject = nullptr;
+		if (SummaryObject.TryGetObjectField(TEXT("FrameStats"), FrameStatsObject))
+		{
+			const FJsonObject& FrameStats = **FrameStatsObject;
+			FFrameStats& Stats = Summary.FrameStats;
+			Stats.FrameCount = FrameStats.GetIntegerField(TEXT("FrameCount"));
+			Stats.DurationSecs = FrameStats.GetNumberField(TEXT("DurationSecs"));
+			Stats.AvgFrameMs = FrameStats.GetNumberField(TEXT("AvgFrameMs"));
+			FrameStats.TryGetNumberField(TEXT("StdDevFrameMs"), Stats.StdDevFrameMs);
+			Stats.P95FrameMs = FrameStats.GetNumberField(TEXT("P95FrameMs"));
+			Stats.MaxFrameMs = FrameStats.GetNumberField(TEXT("MaxFrameMs"));
+			Stats.AvgGameThreadMs = FrameStats.GetNumberField(TEXT("AvgGameThreadMs"));
+			Stats.AvgRenderThreadMs = FrameStats.GetNumberField(TEXT("AvgRenderThreadMs"));
+			Stats.AvgGPUMs = FrameStats.GetNumberField(TEXT("AvgGPUMs"));
+		}
+
+		const TArray<TSharedPtr<FJsonValue>>* Metrics = nullptr;
+		if (SummaryObject.TryGetArrayField(TEXT("Metrics"), Metrics))
+		{
+			for (const TSharedPtr<FJsonValue>& Metric : *Metrics)
+			{
+				const TSharedPtr<FJsonObject> MetricObject = Metric->AsObject();
+				Summary.AddMetric(MetricObject->GetStringField(TEXT("Name")), MetricObject->GetNumberField(TEXT("Value")));
+			}
+		}
+
+		return Summary;
+	}
+
+	static TSharedRef<FJsonObject> MapResultToJson(const FMapBatchResult& Result)
+	{
+		TArray<TSharedPtr<FJsonValue>> SummaryValues;
+		for (const FCameraCaptureSummary& Summary : Result.Summaries)
+		{
+			SummaryValues.Add(MakeShared<FJsonValueObject>(SummaryToJson(Summary)));
+		}
+
+		const TSharedRef<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+		ResultObject->SetStringField(TEXT("Map"), Result.Map);
+		ResultObject->SetStringField(TEXT("Status"), Result.Status);
+		ResultObject->SetNumberField(TEXT("LoadSecs"), Result.LoadSecs);
+		ResultObject->SetArrayField(TEXT("Summaries"), SummaryValues);
+		return ResultObject;
+	}
+
+	static FMapBatchResult MapResultFromJson(const FJsonObject& ResultObject)
+	{
+		FMapBatchResult Result;
+		Result.Map = ResultObject.GetStringField(TEXT("Map"));
+		Result.Status = ResultObject.GetStringField(TEXT("Status"));
+		Result.LoadSecs = ResultObject.GetNumberField(TEXT("LoadSecs"));
+
+		const TArray<TSharedPtr<FJsonValue>>* SummaryValues = nullptr;
+		if (ResultObject.TryGetArrayField(TEXT("Summaries"), SummaryValues))
+		{
+			for (const TSharedPtr<FJsonValue>& SummaryValue : *SummaryValues)
+			{
+				Result.Summaries.Add(SummaryFromJson(*SummaryValue->AsObject()));
+			}
+		}
+
+		return Result;
+	}
+}
+
+/**
+ * @brief Checkpoint file of the running batch (Saved/BatchProfiler/Checkpoint.json)
+ */
+FString FBatchCheckpoint::GetCheckpointPath()
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("BatchProfiler") / TEXT("Checkpoint.json"));
+}
+
+/**
+ * @brief Removes the checkpoint once nothing is left to resume
+ */
+void FBatchCheckpoint::Discard()
+{
+	IFileManager::Get().Delete(*GetCheckpointPath(), false, true, true);
+}
+
+#pragma region Checkpoint Lifetime
+/**
+ * @brief Reads the checkpoint of an unfinished batch, a camera that was in progress is recorded as failed
+ * @return If an unfinished batch exists
+ */
+bool FBatchCheckpoint::Load()
+{
+	FString CheckpointJson;
+	TSharedPtr<FJsonObject> CheckpointObject;
+	if (!FFileHelper::LoadFileToString(CheckpointJson, *GetCheckpointPath())
+		|| !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(CheckpointJson), CheckpointObject)
+		|| !CheckpointObject.IsValid())
+	{
+		return false;
+	}
+
+	Map = CheckpointObject->GetStringField(TEXT("Map"));
+	CaptureValue = CheckpointObject->GetNumberField(TEXT("CaptureValue"));
+	InProgressCamera = CheckpointObject->GetStringField(TEXT("InProgressCamera"));
+
+	CameraSetFile.Reset();
+	MapIndex = INDEX_NONE;
+	bIsLoadingMap = false;
+	CheckpointObject->TryGetStringField(TEXT("CameraSetFile"), CameraSetFile);
+	CheckpointObject->TryGetNumberField(TEXT("MapIndex"), MapIndex);
+	CheckpointObject->TryGetBoolField(TEXT("LoadingMap"), bIsLoadingMap);
+
+	MapResults.Reset();
+	const TArray<TSharedPtr<FJsonValue>>* MapResultValues = nullptr;
+	if (CheckpointObject->TryGetArrayField(TEXT("MapResults"), MapResultValues))
+	{
+		for (const TSharedPtr<FJsonValue>& MapResultValue : *MapResultValues)
+		{
+			MapResults.Add(BatchCheckpoint::MapResultFromJson(*MapResultValue->AsObject()));
+		}
+	}
+
+	const int64 BackendValue = StaticEnum<EProfilingCaptureBackend>()->GetValueByNameString(CheckpointObject->GetStringField(TEXT("Backend")));
+	Backend = BackendValue != INDEX_NONE ? static_cast<EProfilingCaptureBackend>(BackendValue) : EProfilingCaptureBackend::Trace;
+
+	CompletedCameras.Reset();
+	CheckpointObject->TryGetStringArrayField(TEXT("CompletedCameras"), CompletedCameras);
+
+	FailedCameras.Reset();
+	const TArray<TSharedPtr<FJsonValue>>* Failures = nullptr;
+	if (CheckpointObject->TryGetArrayField(TEXT("FailedCameras"), Failures))
+	{
+		for (const TSharedPtr<FJsonValue>& Failure : *Failures)
+		{
+			const TSharedPtr<FJsonObject> FailureObject = Failure->AsObject();
+			FailedCameras.Emplace(FailureObject->GetStringField(TEXT("Camera")), FailureObject->GetStringField(TEXT("Reason")));
+		}
+	}
+
+	Summaries.Reset();
+	const TArray<TSharedPtr<FJsonValue>>* SummaryValues = nullptr;
+	if (CheckpointObject->TryGetArrayField(TEXT("Summaries"), SummaryValues))
+	{
+		for (const TSharedPtr<FJsonValue>& SummaryValue : *SummaryValues)
+		{
+			Summaries.Add(BatchCheckpoint::SummaryFromJson(*SummaryValue->AsObject()));
+		}
+	}
+
+	// The process died while capturing this camera, skip it so a crashing view cannot block the batch
+	if (!InProgressCamera.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Camera %s did not finish in the previous batch, skipping"), *InProgressCamera);
+		FailedCameras.Emplace(InProgressCamera, BatchCheckpoint::InterruptedReason);
+		InProgressCamera.Reset();
+	}
+
+	return true;
+}
+
+/**
+ * @brief Saves the map of a map batch as loading, progress of its cameras is kept when the map is resumed
+ * @param InCameraSetFile Camera set file of the map batch
+ * @param InMapIndex Index of the map in the camera set file
+ * @param InBackend Capture backend of the map batch
+ * @param InCaptureValue Capture seconds or frame count of the map batch
+ * @param bResume Keeps camera progress of the loaded checkpoint when it is at the same map
+ */
+void FBatchCheckpoint::BeginMap(const FString& InCameraSetFile, const int32 InMapIndex, const EProfilingCaptureBackend InBackend, const float InCaptureValue, const bool bResume)
+{
+	// Results of finished maps are kept for every map of the same map batch
+	const bool bIsSameBatch = Load() && CameraSetFile == InCameraSetFile;
+	if (!bIsSameBatch)
+	{
+		MapResults.Reset();
+	}
+
+	if (!bResume || !bIsSameBatch || MapIndex != InMapIndex)
+	{
+		ResetProgress();
+	}
+
+	Backend = InBackend;
+	CaptureValue = InCaptureValue;
+	CameraSetFile = InCameraSetFile;
+	MapIndex = InMapIndex;
+	bIsLoadingMap = true;
+	Save();
+}
+
+/**
+ * @brief Starts checkpointing a batch
+ * @param InMap Map of the batch
+ * @param InBackend Capture backend of the batch
+ * @param InCaptureValue Capture seconds or frame count of the batch
+ * @param bResume Keeps progress of the loaded checkpoint
+ * @param InCameraSetFile Camera set file when the batch is part of a map batch
+ * @param InMapIndex Index of the map in the camera set file
+ */
+void FBatchCheckpoint::Begin(const FString& InMap, const EProfilingCaptureBackend InBackend, const float InCaptureValue, const bool bResume, const FString& InCameraSetFile, const int32 InMapIndex)
+{
+	if (!bResume)
+	{
+		ResetProgress();
+	}
+
+	if (InCameraSetFile.IsEmpty())
+	{
+		MapResults.Reset();
+	}
+
+	Map = InMap;
+	Backend = InBackend;
+	CaptureValue = InCaptureValue;
+	CameraSetFile = InCameraSetFile;
+	MapIndex = InMapIndex;
+	bIsLoadingMap = false;
+	InProgressCamera.Reset();
+	bIsActive = true;
+	Save();
+}
+
+/**
+ * @brief Reports failed cameras and removes the checkpoint of the completed batch, a map batch continues from its next map
+ */
+void FBatchCheckpoint::Finish()
+{
+	if (!bIsActive)
+	{
+		return;
+	}
+
+	bIsActive = false;
+	if (CameraSetFile.IsEmpty())
+	{
+		Discard();
+	}
+
+	if (FailedCameras.Num() > 0)
+	{
+		FString Report = TEXT("Camera,Reason\n");
+		for (const TPair<FString, FString>& FailedCamera : FailedCameras)
+		{
+			Report += FString::Printf(TEXT("%s,%s\n"), *FailedCamera.Key, *FailedCamera.Value);
+		}
+
+		const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y.%m.%d_%H.%M"));
+		FUtilities::SaveReport(FString::Printf(TEXT("BatchFailures_%s.csv"), *Timestamp), Report);
+		UE_LOG(LogTemp, Warning, TEXT("%d cameras failed during the batch"), FailedCameras.Num());
+	}
+
+	if (!CameraSetFile.IsEmpty())
+	{
+		ResetProgress();
+		MapIndex++;
+		Save();
+	}
+}
+#pragma endregion
+
+/**
+ * @brief Saves the results of every finished map of a map batch, a resumed map batch reports them with its own maps
+ * @param InMapResults Results of the finished maps, the map batch continues with the map after them
+ */
+void FBatchCheckpoint::SaveMapResults(const TArray<FMapBatchResult>& InMapResults)
+{
+	Load();
+	ResetProgress();
+	MapResults = InMapResults;
+	MapIndex = InMapResults.Num();
+	bIsLoadingMap = false;
+	Save();
+}
+
+#pragma region Camera Progress
+/**
+ * @brief Saves the camera as in progress before its capture starts
+ * @param CameraName Captured camera
+ */
+void FBatchCheckpoint::BeginCamera(const FString& CameraName)
+{
+	if (bIsActive)
+	{
+		InProgressCamera = CameraName;
+		Save();
+	}
+}
+
+/**
+ * @brief Saves the camera as completed with its summary
+ * @param CameraName Captured camera
+ * @param Summary Capture summary of the camera, null if the backend has no capture window
+ */
+void FBatchCheckpoint::CompleteCamera(const FString& CameraName, const FCameraCaptureSummary* Summary)
+{
+	// A camera that was failed by the watchdog is not completed by its late callback
+	if (!bIsActive || InProgressCamera != CameraName)
+	{
+		return;
+	}
+
+	CompletedCameras.AddUnique(CameraName);
+	if (Summary)
+	{
+		Summaries.Add(*Summary);
+	}
+
+	InProgressCamera.Reset();
+	Save();
+}
+
+/**
+ * @brief Saves the camera as failed so the batch and later resumes move past it
+ * @param CameraName Captured camera
+ * @param Reason Why the camera failed
+ */
+void FBatchCheckpoint::FailCamera(const FString& CameraName, const FString& Reason)
+{
+	if (!bIsActive)
+	{
+		return;
+	}
+
+	UE_LOG(LogTemp, Error, TEXT("Camera %s failed: %s"), *CameraName, *Reason);
+	FailedCameras.Emplace(CameraName, Reason);
+	InProgressCamera.Reset();
+	Save();
+}
+
+void FBatchCheckpoint::ResetProgress()
+{
+	Map.Reset();
+	InProgressCamera.Reset();
+	CompletedCameras.Reset();
+	FailedCameras.Reset();
+	Summaries.Reset();
+}
+
+bool FBatchCheckpoint::IsCameraProcessed(const FString& CameraName) const
+{
+	if (!bIsActive)
+	{
+		return false;
+	}
+
+	return CompletedCameras.Contains(CameraName) || FailedCameras.ContainsByPredicate([&CameraName](const TPair<FString, FString>& FailedCamera)
+	{
+		return FailedCamera.Key == CameraName;
+	});
+}
+
+void FBatchCheckpoint::Save() const
+{
+	BATCHPROFILER_SCOPE(CheckpointSave);
+	TArray<TSharedPtr<FJsonValue>> Completed;
+	for (const FString& CameraName : CompletedCameras)
+	{
+		Completed.Add(MakeShared<FJsonValueString>(CameraName));
+	}
+
+	TArray<TSharedPtr<FJsonValue>> Failed;
+	for (const TPair<FString, FString>& FailedCamera : FailedCameras)
+	{
+		const TSharedRef<FJsonObject> FailureObject = MakeShared<FJsonObject>();
+		FailureObject->SetStringField(TEXT("Camera"), FailedCamera.Key);
+		FailureObject->SetStringField(TEXT("Reason"), FailedCamera.Value);
+		Failed.Add(MakeShared<FJsonValueObject>(FailureObject));
+	}
+
+	TArray<TSharedPtr<FJsonValue>> SummaryValues;
+	for (const FCameraCaptureSummary& Summary : Summaries)
+	{
+		SummaryValues.Add(MakeShared<FJsonValueObject>(BatchCheckpoint::SummaryToJson(Summary)));
+	}
+
+	TArray<TSharedPtr<FJsonValue>> MapResultValues;
+	for (const FMapBatchResult& MapResult : MapResults)
+	{
+		MapResultValues.Add(MakeShared<FJsonValueObject>(BatchCheckpoint::MapResultToJson(MapResult)));
+	}
+
+	const TSharedRef<FJsonObject> CheckpointObject = MakeShared<FJsonObject>();
+	CheckpointObject->SetStringField(TEXT("Map"), Map);
+	CheckpointObject->SetStringField(TEXT("Backend"), StaticEnum<EProfilingCaptureBackend>()->GetNameStringByValue(static_cast<int64>(Backend)));
+	CheckpointObject->SetNumberField(TEXT("CaptureValue"), CaptureValue);
+	CheckpointObject->SetStringField(TEXT("CameraSetFile"), CameraSetFile);
+	CheckpointObject->SetNumberField(TEXT("MapIndex"), MapIndex);
+	CheckpointObject->SetBoolField(TEXT("LoadingMap"), bIsLoadingMap);
+	CheckpointObject->SetStringField(TEXT("InProgressCamera"), InProgressCamera);
+	CheckpointObject->SetArrayField(TEXT("CompletedCameras"), Completed);
+	CheckpointObject->SetArrayField(TEXT("FailedCameras"), Failed);
+	CheckpointObject->SetArrayField(TEXT("Summaries"), SummaryValues);
+	CheckpointObject->SetArrayField(TEXT("MapResults"), MapResultValues);
+
+	FString CheckpointJson;
+	FJsonSerializer::Serialize(CheckpointObject, TJsonWriterFactory<>::Create(&CheckpointJson));
+
+	// Written to a temporary file first so a crash while saving keeps the previous checkpoint
+	const FString CheckpointPath = GetCheckpointPath();
+	const FString TempPath = CheckpointPath + TEXT(".tmp");
+	if (FFileHelper::SaveStringToFile(CheckpointJson, *TempPath))
+	{
+		IFileManager::Get().Move(*CheckpointPath, *TempPath, true, true);
+	}
+}
+#pragma endregion
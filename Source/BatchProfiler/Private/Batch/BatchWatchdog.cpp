@@ -0,0 +1,62 @@
+#include "Batch/BatchWatchdog.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/OutputDeviceRedirector.h"
+
+namespace BatchWatchdog
+{
+	static constexpr uint32 CheckIntervalMs = 1000;
+
+	// Distinguishes a watchdog exit from a crash or a regular exit for the machine relaunching the batch
+	static constexpr uint8 HungExitCode = 3;
+}
+
+FBatchWatchdog::FBatchWatchdog(const double InHangSeconds)
+	: HangSeconds(InHangSeconds), LastHeartbeat(FPlatformTime::Seconds())
+{
+	StopEvent = FPlatformProcess::GetSynchEventFromPool(true);
+	Thread = FRunnableThread::Create(this, TEXT("BatchProfilerWatchdog"), 0, TPri_BelowNormal);
+}
+
+FBatchWatchdog::~FBatchWatchdog()
+{
+	if (Thread)
+	{
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(StopEvent);
+	StopEvent = nullptr;
+}
+
+/**
+ * @brief Called from the game thread while it is making progress
+ */
+void FBatchWatchdog::Heartbeat()
+{
+	LastHeartbeat.store(FPlatformTime::Seconds(), std::memory_order_relaxed);
+}
+
+uint32 FBatchWatchdog::Run()
+{
+	while (!StopEvent->Wait(BatchWatchdog::CheckIntervalMs))
+	{
+		const double SilentSecs = FPlatformTime::Seconds() - LastHeartbeat.load(std::memory_order_relaxed);
+		if (SilentSecs > HangSeconds)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Game thread did not respond for %.0f seconds during the batch, exiting so the batch can be resumed"), SilentSecs);
+			GLog->Flush();
+			FPlatformMisc::RequestExitWithStatus(true, BatchWatchdog::HungExitCode);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+void FBatchWatchdog::Stop()
+{
+	StopEvent->Trigger();
+}
@@ -0,0 +1,338 @@
+#include "Batch/MapBatch.h"
+#include "Utilities/ProfilerStats.h"
+#include "BatchProfiler.h"
+#include "JsonObjectConverter.h"
+#include "ProfilingCamera.h"
+#include "Camera/CameraComponent.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Utilities/Utilities.h"
+
+namespace MapBatch
+{
+	static constexpr double MapLoadTimeoutSecs = 600.0;
+	static constexpr double CameraTimeoutSecs = 30.0;
+}
+
+FMapBatch::FMapBatch(FBatchProfilerModule& InProfilerModule)
+	: ProfilerModule(InProfilerModule)
+{
+}
+
+FMapBatch::~FMapBatch()
+{
+	Stop();
+}
+
+/**
+ * @brief Reads a camera set file
+ * @param CameraSetPath Absolute or project relative path of the json file
+ * @param OutCameraSetFile Parsed camera sets
+ * @return If the file is valid
+ */
+bool FMapBatch::LoadCameraSetFile(const FString& CameraSetPath, FProfilingCameraSetFile& OutCameraSetFile)
+{
+	const FString FullPath = FPaths::IsRelative(CameraSetPath) ? FPaths::ProjectDir() / CameraSetPath : CameraSetPath;
+
+	FString CameraSetJson;
+	if (!FFileHelper::LoadFileToString(CameraSetJson, *FullPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not read camera set file %s"), *FullPath);
+		return false;
+	}
+
+	if (!FJsonObjectConverter::JsonObjectStringToUStruct(CameraSetJson, &OutCameraSetFile))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Camera set file %s is not valid"), *FullPath);
+		return false;
+	}
+
+	return OutCameraSetFile.Maps.Num() > 0;
+}
+
+#pragma region Batch Lifetime
+/**
+ * @brief Starts walking the maps of a camera set file
+ * @param CameraSetPath Path of the camera set json
+ * @param InBackend Capture backend used at each map
+ * @param InCaptureValue Capture seconds or frame count, 0 for the settings default
+ * @param ResumeMapIndex Map of the checkpoint to resume from, INDEX_NONE starts a new batch
+ * @return If the batch is started
+ */
+bool FMapBatch::Start(const FString& CameraSetPath, const EProfilingCaptureBackend InBackend, const float InCaptureValue, const int32 ResumeMapIndex)
+{
+	Stop();
+
+	CameraSetFile = FProfilingCameraSetFile();
+	if (FUtilities::GetGameWorld() == nullptr || !LoadCameraSetFile(CameraSetPath, CameraSetFile))
+	{
+		return false;
+	}
+
+	CameraSetFilePath = CameraSetPath;
+	Backend = InBackend;
+	CaptureValue = InCaptureValue;
+	MapIndex = FMath::Max(ResumeMapIndex, 0);
+	bResumeMap = ResumeMapIndex != INDEX_NONE;
+	MapResults.Reset();
+
+	if (bResumeMap)
+	{
+		// Maps finished before the batch was interrupted are reported with the resumed maps
+		FBatchCheckpoint Checkpoint;
+		if (Checkpoint.Load() && Checkpoint.GetCameraSetFile() == CameraSetPath)
+		{
+			MapResults = Checkpoint.GetMapResults();
+		}
+
+		// Maps skipped on resume crashed the previous process while loading
+		while (MapResults.Num() < MapIndex && CameraSetFile.Maps.IsValidIndex(MapResults.Num()))
+		{
+			FMapBatchResult& Result = MapResults.AddDefaulted_GetRef();
+			Result.Map = CameraSetFile.Maps[MapResults.Num() - 1].Map;
+			Result.Status = TEXT("MapLoadCrashed");
+		}
+	}
+	else
+	{
+		// A new map batch replaces the checkpoint of any previous batch
+		FBatchCheckpoint::Discard();
+	}
+
+	Phase = EPhase::StartingMap;
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMapBatch::Tick));
+
+	return true;
+}
+
+/**
+ * @brief Stops the batch after the current map, results gathered so far are still reported
+ */
+void FMapBatch::Stop()
+{
+	if (!TickerHandle.IsValid())
+	{
+		return;
+	}
+
+	if (Phase != EPhase::StartingMap)
+	{
+		FinishMap(TEXT("Stopped"));
+	}
+
+	// The checkpoint is kept so the stopped batch can be resumed from its map
+	ProfilerModule.SetMapBatchProgress(FString(), INDEX_NONE);
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+	WriteReport();
+}
+
+bool FMapBatch::Tick(float DeltaTime)
+{
+	BATCHPROFILER_SCOPE(MapBatchTick);
+	const double Now = FPlatformTime::Seconds();
+
+	switch (Phase)
+	{
+	case EPhase::StartingMap:
+		// Maps are started from the ticker so the previous batch unwinds before its world is torn down
+		StartMap();
+		break;
+
+	case EPhase::LoadingMap:
+		if (Now > PhaseTimeout)
+		{
+			FinishMap(TEXT("MapLoadTimedOut"));
+		}
+		break;
+
+	case EPhase::WaitingForCameras:
+		// Spawned and placed cameras register on BeginPlay, which happens after the map is loaded
+		if (ProfilerModule.GetBatchCameras().Num() > 0)
+		{
+			Phase = EPhase::Capturing;
+			CaptureCompleteHandle = ProfilerModule.OnCaptureComplete().AddRaw(this, &FMapBatch::OnCaptureComplete);
+			if (!ProfilerModule.StartBatch(Backend, CaptureValue))
+			{
+				FinishMap(TEXT("BatchFailed"));
+			}
+		}
+		else if (Now > PhaseTimeout)
+		{
+			FinishMap(TEXT("NoCameras"));
+		}
+		break;
+
+	case EPhase::Capturing:
+		break;
+	}
+
+	return true;
+}
+#pragma endregion
+
+#pragma region Maps
+void FMapBatch::StartMap()
+{
+	if (!CameraSetFile.Maps.IsValidIndex(MapIndex))
+	{
+		ProfilerModule.SetMapBatchProgress(FString(), INDEX_NONE);
+		FBatchCheckpoint::Discard();
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+		WriteReport();
+		FUtilities::ShowNotification(FString::Printf(TEXT("Map batch completed for %d maps"), MapResults.Num()), true);
+		return;
+	}
+
+	const FProfilingCameraSet& CameraSet = CameraSetFile.Maps[MapIndex];
+	FMapBatchResult& Result = MapResults.AddDefaulted_GetRef();
+	Result.Map = CameraSet.Map;
+
+	// Only the cameras of the set are captured, placed cameras are used when the set has none
+	TArray<FString> CameraNames;
+	for (const FProfilingCameraDefinition& Camera : CameraSet.Cameras)
+	{
+		CameraNames.Add(Camera.Name);
+	}
+	ProfilerModule.SetCameraFilter(CameraNames);
+
+	// The map is saved as loading first, a map that crashes the process while loading is skipped on resume
+	ProfilerModule.SetMapBatchProgress(CameraSetFilePath, MapIndex);
+	if (GetDefault<UBatchProfilerSettings>()->WriteBatchCheckpoints)
+	{
+		FBatchCheckpoint Checkpoint;
+		Checkpoint.BeginMap(CameraSetFilePath, MapIndex, Backend, CaptureValue, bResumeMap);
+	}
+	bResumeMap = false;
+
+	// The map is always reloaded so every map gets a comparable load time
+	Phase = EPhase::LoadingMap;
+	PhaseTimeout = FPlatformTime::Seconds() + MapBatch::MapLoadTimeoutSecs;
+	if (!MapLoader.LoadMap(CameraSet.Map, FMapLoader::FOnMapLoaded::CreateRaw(this, &FMapBatch::OnMapLoaded)))
+	{
+		FinishMap(TEXT("MapLoadFailed"));
+	}
+}
+
+void FMapBatch::OnMapLoaded(UWorld* World, const double LoadSecs)
+{
+	if (World == nullptr)
+	{
+		FinishMap(TEXT("MapLoadFailed"));
+		return;
+	}
+
+	MapResults.Last().LoadSecs = LoadSecs;
+	SpawnCameras(World, CameraSetFile.Maps[MapIndex]);
+
+	Phase = EPhase::WaitingForCameras;
+	PhaseTimeout = FPlatformTime::Seconds() + MapBatch::CameraTimeoutSecs;
+}
+
+/**
+ * @brief Spawns transient profiling cameras of the set, they are destroyed with the world
+ * @param World Loaded world
+ * @param CameraSet Cameras of the map
+ */
+void FMapBatch::SpawnCameras(UWorld* World, const FProfilingCameraSet& CameraSet) const
+{
+	for (const FProfilingCameraDefinition& Definition : CameraSet.Cameras)
+	{
+		const FTransform Transform(Definition.Rotation, Definition.Location);
+		AProfilingCamera* Camera = World->SpawnActorDeferred<AProfilingCamera>(AProfilingCamera::StaticClass(), Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (Camera == nullptr)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Could not spawn camera %s"), *Definition.Name);
+			continue;
+		}
+
+		// Properties are set before spawning finishes, cameras register on BeginPlay
+		Camera->SetFlags(RF_Transient);
+		Camera->CameraName = Definition.Name;
+		Camera->FrameBudgetMs = Definition.FrameBudgetMs;
+		Camera->IsActiveOnProfiling = true;
+		Camera->GetCameraComponent()->SetFieldOfView(Definition.FieldOfView);
+		Camera->FinishSpawning(Transform);
+	}
+}
+
+void FMapBatch::OnCaptureComplete()
+{
+	if (Phase == EPhase::Capturing)
+	{
+		MapResults.Last().Summaries = ProfilerModule.GetCaptureSummaries();
+		FinishMap(TEXT("Succeeded"));
+	}
+}
+
+/**
+ * @brief Records the status of the current map and moves on to the next map
+ * @param Status Result of the map
+ */
+void FMapBatch::FinishMap(const FString& Status)
+{
+	ProfilerModule.OnCaptureComplete().Remove(CaptureCompleteHandle);
+	CaptureCompleteHandle.Reset();
+	ProfilerModule.SetCameraFilter(TArray<FString>());
+
+	if (MapResults.Num() > 0)
+	{
+		MapResults.Last().Status = Status;
+		if (Status != TEXT("Succeeded"))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Map batch %s: %s"), *MapResults.Last().Map, *Status);
+		}
+
+		// A stopped map is not saved as finished so the resumed batch captures its remaining cameras
+		if (Status != TEXT("Stopped") && GetDefault<UBatchProfilerSettings>()->WriteBatchCheckpoints)
+		{
+			FBatchCheckpoint Checkpoint;
+			Checkpoint.SaveMapResults(MapResults);
+		}
+	}
+
+	MapIndex++;
+	Phase = EPhase::StartingMap;
+}
+#pragma endregion
+
+#pragma region Report
+/**
+ * @brief Writes load time and capture results of every map, frame times are compared against camera budgets
+ */
+void FMapBatch::WriteReport() const
+{
+	if (MapResults.Num() == 0)
+	{
+		return;
+	}
+
+	FString Report = TEXT("Map,Status,LoadSecs,Camera,Frames,AvgFrameMs,P95FrameMs,MaxFrameMs,FrameBudgetMs,OverBudgetMs\n");
+	for (const FMapBatchResult& Result : MapResults)
+	{
+		if (Result.Summaries.Num() == 0)
+		{
+			Report += FString::Printf(TEXT("%s,%s,%.3f,,,,,,,\n"), *Result.Map, *Result.Status, Result.LoadSecs);
+			continue;
+		}
+
+		for (const FCameraCaptureSummary& Summary : Result.Summaries)
+		{
+			const TPair<FString, double>* Budget = Summary.Metrics.FindByPredicate([](const TPair<FString, double>& Metric)
+			{
+				return Metric.Key == TEXT("FrameBudgetMs");
+			});
+
+			const FFrameStats& Stats = Summary.FrameStats;
+			Report += FString::Printf(TEXT("%s,%s,%.3f,%s,%d,%.3f,%.3f,%.3f"), *Result.Map, *Result.Status, Result.LoadSecs,
+				*Summary.CameraName, Stats.FrameCount, Stats.AvgFrameMs, Stats.P95FrameMs, Stats.MaxFrameMs);
+			Report += Budget ? FString::Printf(TEXT(",%.3f,%.3f\n"), Budget->Value, Stats.AvgFrameMs - Budget->Value) : FString(TEXT(",,\n"));
+		}
+	}
+
+	const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y.%m.%d_%H.%M"));
+	FUtilities::SaveReport(FString::Printf(TEXT("MapBatch_%s.csv"), *Timestamp), Report);
+}
+#pragma endregion
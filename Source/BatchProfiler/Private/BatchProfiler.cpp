@@ -2,8 +2,17 @@
 
 #include "BatchProfiler.h"
 #include "BatchProfilerSettings.h"
+#include "Analysis/StaticCostAnalyzer.h"
+#include "Capture/ColdArrivalCollector.h"
+#include "Capture/GarbageCollectionCollector.h"
+#include "Capture/PerfCounterCollector.h"
+#include "Capture/ThreadOccupancyCollector.h"
+#include "Capture/TickCostCollector.h"
+#include "Telemetry/FrameTelemetryCollector.h"
 #include "ISettingsModule.h"
 #include "Framework/Notifications/NotificationManager.h"
+#include "Utilities/ProfilerStats.h"
+#include "Utilities/TraceChannels.h"
 #include "Utilities/Utilities.h"
 
 #pragma region Module Initialization
@@ -18,6 +27,15 @@ void FBatchProfilerModule::StartupModule()
 										 GetMutableDefault<UBatchProfilerSettings>());
 	}
 	
+	// Create Capture Collectors
+	TickCostCollector = MakeShared<FTickCostCollector>();
+	CaptureCollectors.Add(TickCostCollector.ToSharedRef());
+	CaptureCollectors.Add(MakeShared<FThreadOccupancyCollector>());
+	CaptureCollectors.Add(MakeShared<FColdArrivalCollector>());
+	CaptureCollectors.Add(MakeShared<FPerfCounterCollector>());
+	CaptureCollectors.Add(MakeShared<FGarbageCollectionCollector>());
+	CaptureCollectors.Add(MakeShared<FFrameTelemetryCollector>());
+
 	// Define Delegates
 	FConsoleCommandWithArgsDelegate NextCameraDelegate;
 	FConsoleCommandWithArgsDelegate PrevCameraDelegate;
@@ -31,6 +49,21 @@ void FBatchProfilerModule::StartupModule()
 	FConsoleCommandWithArgsDelegate StartRenderDocDelegate;
 	FConsoleCommandWithArgsDelegate BatchRenderDocDelegate;
 
+	FConsoleCommandWithArgsDelegate CalibrateTraceDelegate;
+	FConsoleCommandWithArgsDelegate ListTraceChannelsDelegate;
+	FConsoleCommandWithArgsDelegate AnalyzeStaticCostDelegate;
+	FConsoleCommandWithArgsDelegate TickDiffDelegate;
+	FConsoleCommandWithArgsDelegate StartExperimentDelegate;
+	FConsoleCommandWithArgsDelegate StartSweepDelegate;
+	FConsoleCommandWithArgsDelegate StartServiceDelegate;
+	FConsoleCommandWithArgsDelegate StopServiceDelegate;
+	FConsoleCommandWithArgsDelegate RecordReplayDelegate;
+	FConsoleCommandWithArgsDelegate StopReplayDelegate;
+	FConsoleCommandWithArgsDelegate StartReplayDelegate;
+	FConsoleCommandWithArgsDelegate StartMapBatchDelegate;
+	FConsoleCommandWithArgsDelegate ResumeBatchDelegate;
+	FConsoleCommandWithArgsDelegate OverheadBenchmarkDelegate;
+
 	// Bind Delegates
 	NextCameraDelegate.BindRaw(this, &FBatchProfilerModule::NextCameraCommand);
 	PrevCameraDelegate.BindRaw(this, &FBatchProfilerModule::PrevCameraCommand);
@@ -62,6 +95,21 @@ void FBatchProfilerModule::StartupModule()
 		StartRenderDocCommand(Args, true); // Batch frame capture with RenderDoc
 	});
 
+	CalibrateTraceDelegate.BindRaw(this, &FBatchProfilerModule::CalibrateTraceCommand);
+	ListTraceChannelsDelegate.BindRaw(this, &FBatchProfilerModule::ListTraceChannelsCommand);
+	AnalyzeStaticCostDelegate.BindRaw(this, &FBatchProfilerModule::AnalyzeStaticCostCommand);
+	TickDiffDelegate.BindRaw(this, &FBatchProfilerModule::TickDiffCommand);
+	StartExperimentDelegate.BindRaw(this, &FBatchProfilerModule::StartExperimentCommand);
+	StartSweepDelegate.BindRaw(this, &FBatchProfilerModule::StartSweepCommand);
+	StartServiceDelegate.BindRaw(this, &FBatchProfilerModule::StartServiceCommand);
+	StopServiceDelegate.BindRaw(this, &FBatchProfilerModule::StopServiceCommand);
+	RecordReplayDelegate.BindRaw(this, &FBatchProfilerModule::RecordReplayCommand);
+	StopReplayDelegate.BindRaw(this, &FBatchProfilerModule::StopReplayCommand);
+	StartReplayDelegate.BindRaw(this, &FBatchProfilerModule::StartReplayCommand);
+	StartMapBatchDelegate.BindRaw(this, &FBatchProfilerModule::StartMapBatchCommand);
+	ResumeBatchDelegate.BindRaw(this, &FBatchProfilerModule::ResumeBatchCommand);
+	OverheadBenchmarkDelegate.BindRaw(this, &FBatchProfilerModule::OverheadBenchmarkCommand);
+
 	// Register Commands 
 	IConsoleManager::Get().RegisterConsoleCommand(
 		TEXT("cp.next"),
@@ -92,6 +140,67 @@ void FBatchProfilerModule::StartupModule()
 		TEXT("Batch runs profiling on each ProfilingCamera using UE Insight"),
 		BatchInsightTraceDelegate);
 
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.calibrate.trace"),
+		TEXT("Measures frame time overhead and bytes/sec of each trace channel on active camera"),
+		CalibrateTraceDelegate);
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.trace.channels"),
+		TEXT("Lists profiling trace channels and if they are registered by the engine"),
+		ListTraceChannelsDelegate);
+
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.analyze.static"),
+		TEXT("Estimates static render cost of each ProfilingCamera frustum without rendering"),
+		AnalyzeStaticCostDelegate);
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.tick.diff"),
+		TEXT("Logs tick cost difference between two cameras of the last batch (CameraA CameraB)"),
+		TickDiffDelegate);
+
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.batch.experiment"),
+		TEXT("Batch compares CVar sets on each ProfilingCamera using interleaved windows"),
+		StartExperimentDelegate);
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.batch.sweep"),
+		TEXT("Batch captures each ProfilingCamera while the population of an actor class grows in steps (ActorClassPath)"),
+		StartSweepDelegate);
+
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.service.start"),
+		TEXT("Runs batch requests from a local spool directory in this instance (SpoolDirectory)"),
+		StartServiceDelegate);
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.service.stop"),
+		TEXT("Stops running batch requests from the spool directory"),
+		StopServiceDelegate);
+
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.replay.record"),
+		TEXT("Starts recording a replay of the gameplay session (ReplayName)"),
+		RecordReplayDelegate);
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.replay.stop"),
+		TEXT("Stops recording the replay"),
+		StopReplayDelegate);
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.batch.replay"),
+		TEXT("Batch plays back the same replay segment from each ProfilingCamera (ReplayName StartSeconds DurationSeconds)"),
+		StartReplayDelegate);
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.batch.maps"),
+		TEXT("Batch loads each map of a camera set file and profiles its cameras (CameraSetFile Backend CaptureValue)"),
+		StartMapBatchDelegate);
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.batch.resume"),
+		TEXT("Resumes the interrupted batch from its checkpoint, skipping captured and failed cameras"),
+		ResumeBatchDelegate);
+	IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("cp.benchmark.overhead"),
+		TEXT("Runs a synthetic batch and reports the time the plugin spends per frame and per camera (CameraCount WindowSeconds)"),
+		OverheadBenchmarkDelegate);
+
 #if PLATFORM_WINDOWS || PLATFORM_LINUX
 	IConsoleManager::Get().RegisterConsoleCommand(
 		TEXT("cp.run.renderdoc"),
@@ -103,6 +212,14 @@ void FBatchProfilerModule::StartupModule()
 		BatchRenderDocDelegate);
 #endif
 	
+	// Start the profiling service when launched with -BatchProfilerService[=SpoolDirectory]
+	ProfilingService = MakeUnique<FProfilingService>(*this);
+	FString SpoolDirectory;
+	if (FParse::Value(FCommandLine::Get(), TEXT("BatchProfilerService="), SpoolDirectory) || FParse::Param(FCommandLine::Get(), TEXT("BatchProfilerService")))
+	{
+		ProfilingService->Start(SpoolDirectory);
+	}
+
 	UE_LOG(LogTemp, Display, TEXT("Batch Profiler Initialized"));
 }
 
@@ -125,12 +242,38 @@ void FBatchProfilerModule::ShutdownModule()
 	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.batch.trace"));
 	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.run.snapshot"));
 	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.batch.snapshot"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.calibrate.trace"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.trace.channels"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.analyze.static"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.tick.diff"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.batch.experiment"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.batch.sweep"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.service.start"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.service.stop"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.replay.record"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.replay.stop"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.batch.replay"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.batch.maps"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.batch.resume"));
+	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.benchmark.overhead"));
 
 #if PLATFORM_WINDOWS || PLATFORM_LINUX
 	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.run.renderdoc"));
 	IConsoleManager::Get().UnregisterConsoleObject(TEXT("cp.batch.renderdoc"));
 #endif	
 
+	ProfilingService.Reset();
+	ReplayProfiler.Reset();
+	MapBatch.Reset();
+	OverheadBenchmark.Reset();
+
+	StopWatchdog();
+	TraceChannelCalibrator.Reset();
+	CVarExperiment.Reset();
+	LoadSweep.Reset();
+	CaptureCollectors.Empty();
+	TickCostCollector.Reset();
+
 	UE_LOG(LogTemp, Display, TEXT("Batch Profiler Shutdown"));
 }
 #pragma endregion
@@ -180,6 +323,12 @@ void FBatchProfilerModule::StartInsightCommand(const TArray<FString>& Args, cons
 	{
 		CaptureSecs = FCString::Atof(*Args[0]); // The second argument is the capture duration
 	}
+
+	if (IsBatch && !BeginCheckpoint(IsSnapshot ? EProfilingCaptureBackend::Snapshot : EProfilingCaptureBackend::Trace, CaptureSecs))
+	{
+		CompleteCapture(); // Every camera was captured before the batch was resumed
+		return;
+	}
 	
 	CaptureWithInsight(CaptureSecs, IsBatch, IsSnapshot);
 }
@@ -204,8 +353,371 @@ void FBatchProfilerModule::StartRenderDocCommand(const TArray<FString>& Args, co
 		FrameCount = FCString::Atoi(*Args[0]);
 	}
 
+	if (IsBatch && !BeginCheckpoint(EProfilingCaptureBackend::RenderDoc, FrameCount))
+	{
+		CompleteCapture(); // Every camera was captured before the batch was resumed
+		return;
+	}
+
 	CaptureWithRenderDoc(FrameCount, IsBatch);
 }
+
+/**
+ * @brief Captures active camera with each trace channel on its own and reports the overhead per channel
+ * @param Args From console command (Seconds per channel)
+ */
+void FBatchProfilerModule::CalibrateTraceCommand(const TArray<FString>& Args)
+{
+	if (TraceChannelCalibrator.IsValid() && TraceChannelCalibrator->IsRunning())
+	{
+		FUtilities::ShowNotification(TEXT("Trace calibration is already running."), false);
+		return;
+	}
+
+	if (ActiveCamera == nullptr)
+	{
+		FUtilities::ShowNotification(TEXT("No camera selected for profiling."), false);
+		return;
+	}
+
+	float MeasureSecs = BatchProfilerSettings->TraceSettings.CalibrationSeconds;
+	if (Args.Num() >= 1)
+	{
+		MeasureSecs = FCString::Atof(*Args[0]);
+	}
+
+	FSlateNotificationManager::Get().SetAllowNotifications(false);
+	ActiveCamera->ActivateCamera();
+
+	TraceChannelCalibrator = MakeUnique<FTraceChannelCalibrator>(ActiveCamera->CameraName, BatchProfilerSettings->DelayBeforeEachCapture, MeasureSecs);
+	TraceChannelCalibrator->Start(FSimpleDelegate::CreateLambda([]()
+	{
+		FSlateNotificationManager::Get().SetAllowNotifications(true);
+		FUtilities::ShowNotification(TEXT("Trace Calibration Complete"), true);
+	}));
+}
+
+/**
+ * @brief Logs the engine identifier of each profiling trace channel and if it is registered
+ */
+void FBatchProfilerModule::ListTraceChannelsCommand(const TArray<FString>& Args)
+{
+	const UEnum* TraceEnum = StaticEnum<EProfilingTraceChannel>();
+	for (int32 EnumIndex = 0; EnumIndex < TraceEnum->NumEnums() - 1; ++EnumIndex)
+	{
+		const EProfilingTraceChannel Channel = static_cast<EProfilingTraceChannel>(TraceEnum->GetValueByIndex(EnumIndex));
+		const FString ChannelName = FTraceChannels::GetChannelName(Channel);
+		const bool bIsRegistered = FTraceChannels::IsChannelRegistered(ChannelName);
+
+		UE_LOG(LogTemp, Display, TEXT("%s -> %s (%s)"), *TraceEnum->GetDisplayNameTextByIndex(EnumIndex).ToString(), *ChannelName,
+			bIsRegistered ? TEXT("Registered") : TEXT("Not Registered"));
+	}
+}
+
+/**
+ * @brief Estimates static render cost of every Profiling Camera frustum on the CPU
+ * @param Args From console command (Top primitive count)
+ */
+void FBatchProfilerModule::AnalyzeStaticCostCommand(const TArray<FString>& Args)
+{
+	if (ProfilingCameras.Num() == 0)
+	{
+		FUtilities::ShowNotification(TEXT("No active cameras found in world"), false);
+		return;
+	}
+
+	int TopCount = BatchProfilerSettings->StaticCostTopPrimitiveCount;
+	if (Args.Num() >= 1)
+	{
+		TopCount = FCString::Atoi(*Args[0]);
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const TArray<AProfilingCamera*> BatchCameras = GetBatchCameras();
+	const FStaticCostAnalyzer Analyzer(ProfilingCameras[0]->GetWorld());
+	const TArray<FStaticCostReport> Reports = Analyzer.Analyze(BatchCameras, TopCount);
+	FStaticCostAnalyzer::WriteReport(Reports);
+
+	UE_LOG(LogTemp, Display, TEXT("Analyzed static cost of %i cameras in %.2f seconds"), Reports.Num(), FPlatformTime::Seconds() - StartTime);
+	FUtilities::ShowNotification(TEXT("Static Cost Analysis Complete"), true);
+}
+
+/**
+ * @brief Logs tick cost difference between two cameras of the last batch
+ * @param Args From console command (CameraA CameraB)
+ */
+void FBatchProfilerModule::TickDiffCommand(const TArray<FString>& Args)
+{
+	if (Args.Num() < 2)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Usage: cp.tick.diff CameraA CameraB"));
+		return;
+	}
+
+	TickCostCollector->LogDiff(Args[0], Args[1]);
+}
+
+/**
+ * @brief Compares CVar sets on each Profiling Camera by alternating them in interleaved windows
+ * @param Args From console command (Rounds)
+ */
+void FBatchProfilerModule::StartExperimentCommand(const TArray<FString>& Args)
+{
+	if (CVarExperiment.IsValid() && CVarExperiment->IsRunning())
+	{
+		FUtilities::ShowNotification(TEXT("An experiment is already running."), false);
+		return;
+	}
+
+	if (BatchProfilerSettings->ExperimentCVarSets.Num() < 2)
+	{
+		FUtilities::ShowNotification(TEXT("At least two CVar sets are required for an experiment."), false);
+		return;
+	}
+
+	if (TryInitCapture(true) == false)
+	{
+		return;
+	}
+
+	int Rounds = BatchProfilerSettings->ExperimentRounds;
+	if (Args.Num() >= 1)
+	{
+		Rounds = FCString::Atoi(*Args[0]);
+	}
+
+	FSlateNotificationManager::Get().SetAllowNotifications(false);
+
+	CVarExperiment = MakeUnique<FCVarExperiment>(GetBatchCameras(), BatchProfilerSettings->ExperimentCVarSets, Rounds);
+	CVarExperiment->Start(FSimpleDelegate::CreateRaw(this, &FBatchProfilerModule::CompleteCapture));
+}
+
+/**
+ * @brief Captures each Profiling Camera while the population of an actor class grows in steps
+ * @param Args From console command (Actor class path)
+ */
+void FBatchProfilerModule::StartSweepCommand(const TArray<FString>& Args)
+{
+	if (LoadSweep.IsValid() && LoadSweep->IsRunning())
+	{
+		FUtilities::ShowNotification(TEXT("A load sweep is already running."), false);
+		return;
+	}
+
+	const TSoftClassPtr<AActor> SweepActorClass = Args.Num() >= 1
+		? TSoftClassPtr<AActor>(FSoftObjectPath(Args[0]))
+		: BatchProfilerSettings->SweepActorClass;
+
+	UClass* ActorClass = SweepActorClass.LoadSynchronous();
+	if (ActorClass == nullptr)
+	{
+		FUtilities::ShowNotification(TEXT("No actor class to sweep."), false);
+		return;
+	}
+
+	if (BatchProfilerSettings->SweepCounts.Num() < 2)
+	{
+		FUtilities::ShowNotification(TEXT("At least two sweep counts are required."), false);
+		return;
+	}
+
+	if (TryInitCapture(true) == false)
+	{
+		return;
+	}
+
+	FSlateNotificationManager::Get().SetAllowNotifications(false);
+
+	LoadSweep = MakeUnique<FLoadSweep>(GetBatchCameras(), ActorClass, BatchProfilerSettings->SweepCounts);
+	LoadSweep->Start(FSimpleDelegate::CreateRaw(this, &FBatchProfilerModule::CompleteCapture));
+}
+
+/**
+ * @brief Starts running batch requests from a spool directory
+ * @param Args From console command (Spool directory)
+ */
+void FBatchProfilerModule::StartServiceCommand(const TArray<FString>& Args)
+{
+	ProfilingService->Start(Args.Num() >= 1 ? Args[0] : FString());
+}
+
+/**
+ * @brief Stops running batch requests from the spool directory
+ */
+void FBatchProfilerModule::StopServiceCommand(const TArray<FString>& Args)
+{
+	ProfilingService->Stop();
+}
+
+/**
+ * @brief Loads each map of a camera set file, spawns its cameras and runs the batch on them
+ * @param Args From console command (Camera set file, Backend, Capture value)
+ */
+void FBatchProfilerModule::StartMapBatchCommand(const TArray<FString>& Args)
+{
+	const FString CameraSetFile = Args.Num() >= 1 ? Args[0] : BatchProfilerSettings->CameraSetFile;
+	const float CaptureValue = Args.Num() >= 3 ? FCString::Atof(*Args[2]) : 0.f;
+
+	EProfilingCaptureBackend Backend = EProfilingCaptureBackend::Trace;
+	if (Args.Num() >= 2)
+	{
+		const int64 BackendValue = StaticEnum<EProfilingCaptureBackend>()->GetValueByNameString(Args[1]);
+		if (BackendValue == INDEX_NONE)
+		{
+			FUtilities::ShowNotification(FString::Printf(TEXT("Unknown capture backend %s"), *Args[1]), false);
+			return;
+		}
+
+		Backend = static_cast<EProfilingCaptureBackend>(BackendValue);
+	}
+
+	// A relaunched map batch continues from the map of its checkpoint
+	int32 ResumeMapIndex = INDEX_NONE;
+	FBatchCheckpoint Checkpoint;
+	if (FParse::Param(FCommandLine::Get(), TEXT("BatchProfilerResume")) && Checkpoint.Load() && Checkpoint.GetCameraSetFile() == CameraSetFile)
+	{
+		ResumeMapIndex = Checkpoint.IsLoadingMap() ? Checkpoint.GetMapIndex() + 1 : Checkpoint.GetMapIndex();
+	}
+
+	StartMapBatch(CameraSetFile, Backend, CaptureValue, ResumeMapIndex);
+}
+
+/**
+ * @brief Starts a map batch, progress of the batch is saved to the checkpoint at every map
+ * @param CameraSetFile Path of the camera set json
+ * @param Backend Capture backend used at each map
+ * @param CaptureValue Capture seconds or frame count, 0 for the settings default
+ * @param ResumeMapIndex Map of the checkpoint to resume from, INDEX_NONE starts a new batch
+ */
+void FBatchProfilerModule::StartMapBatch(const FString& CameraSetFile, const EProfilingCaptureBackend Backend, const float CaptureValue, const int32 ResumeMapIndex)
+{
+	if (MapBatch.IsValid() && MapBatch->IsRunning())
+	{
+		FUtilities::ShowNotification(TEXT("Map batch is already running."), false);
+		return;
+	}
+
+	MapBatch = MakeUnique<FMapBatch>(*this);
+	if (!MapBatch->Start(CameraSetFile, Backend, CaptureValue, ResumeMapIndex))
+	{
+		FUtilities::ShowNotification(FString::Printf(TEXT("Could not start map batch from %s"), *CameraSetFile), false);
+	}
+}
+
+/**
+ * @brief Resumes the interrupted batch from its checkpoint with the same backend and capture value, map batches continue from their map
+ */
+void FBatchProfilerModule::ResumeBatchCommand(const TArray<FString>& Args)
+{
+	FBatchCheckpoint Checkpoint;
+	if (!Checkpoint.Load())
+	{
+		FUtilities::ShowNotification(TEXT("No batch checkpoint found."), false);
+		return;
+	}
+
+	// A map that crashed the process while loading is skipped, the others continue with their remaining cameras
+	if (!Checkpoint.GetCameraSetFile().IsEmpty())
+	{
+		const int32 ResumeMapIndex = Checkpoint.IsLoadingMap() ? Checkpoint.GetMapIndex() + 1 : Checkpoint.GetMapIndex();
+		StartMapBatch(Checkpoint.GetCameraSetFile(), Checkpoint.GetBackend(), Checkpoint.GetCaptureValue(), ResumeMapIndex);
+		return;
+	}
+
+	// The checkpoint is only replaced by a batch on its own map
+	if (!FMapLoader::IsMapLoaded(Checkpoint.GetMap()))
+	{
+		FUtilities::ShowNotification(FString::Printf(TEXT("Checkpoint is for map %s, load it before resuming."), *Checkpoint.GetMap()), false);
+		return;
+	}
+
+	ResumeRequested = true;
+	if (!StartBatch(Checkpoint.GetBackend(), Checkpoint.GetCaptureValue()))
+	{
+		ResumeRequested = false;
+		FUtilities::ShowNotification(TEXT("Could not resume batch."), false);
+	}
+}
+
+/**
+ * @brief Starts recording a replay of the gameplay session
+ * @param Args From console command (Replay name)
+ */
+void FBatchProfilerModule::RecordReplayCommand(const TArray<FString>& Args)
+{
+	const FString ReplayName = Args.Num() >= 1 ? Args[0] : TEXT("BatchProfilerReplay");
+	if (!FReplayProfiler::StartRecording(ReplayName))
+	{
+		FUtilities::ShowNotification(TEXT("Replays can only be recorded while playing."), false);
+	}
+}
+
+/**
+ * @brief Stops recording the replay
+ */
+void FBatchProfilerModule::StopReplayCommand(const TArray<FString>& Args)
+{
+	FReplayProfiler::StopRecording();
+}
+
+/**
+ * @brief Plays back the same replay segment from each Profiling Camera
+ * @param Args From console command (Replay name, Start seconds, Duration seconds)
+ */
+void FBatchProfilerModule::StartReplayCommand(const TArray<FString>& Args)
+{
+	if (ReplayProfiler.IsValid() && ReplayProfiler->IsRunning())
+	{
+		FUtilities::ShowNotification(TEXT("Replay profiling is already running."), false);
+		return;
+	}
+
+	if (TryInitCapture(true) == false)
+	{
+		return;
+	}
+
+	const FString ReplayName = Args.Num() >= 1 ? Args[0] : TEXT("BatchProfilerReplay");
+	const float StartSecs = Args.Num() >= 2 ? FCString::Atof(*Args[1]) : BatchProfilerSettings->ReplayStartSeconds;
+	const float DurationSecs = Args.Num() >= 3 ? FCString::Atof(*Args[2]) : BatchProfilerSettings->ReplayDurationSeconds;
+
+	// Cameras are recreated with the replay world, so they are tracked by name
+	TArray<FString> CameraNames;
+	for (const AProfilingCamera* Camera : GetBatchCameras())
+	{
+		CameraNames.Add(Camera->CameraName);
+	}
+
+	FSlateNotificationManager::Get().SetAllowNotifications(false);
+
+	ReplayProfiler = MakeUnique<FReplayProfiler>(*this, CameraNames);
+	if (!ReplayProfiler->Start(ReplayName, StartSecs, DurationSecs, FSimpleDelegate::CreateRaw(this, &FBatchProfilerModule::CompleteCapture)))
+	{
+		FSlateNotificationManager::Get().SetAllowNotifications(true);
+		FUtilities::ShowNotification(FString::Printf(TEXT("Could not play replay %s"), *ReplayName), false);
+	}
+}
+
+/**
+ * @brief Runs a synthetic batch through the capture path and reports the overhead of the plugin
+ * @param Args From console command (Camera count, window seconds)
+ */
+void FBatchProfilerModule::OverheadBenchmarkCommand(const TArray<FString>& Args)
+{
+	if (OverheadBenchmark.IsValid() && OverheadBenchmark->IsRunning())
+	{
+		FUtilities::ShowNotification(TEXT("An overhead benchmark is already running."), false);
+		return;
+	}
+
+	const int32 CameraCount = Args.Num() >= 1 ? FCString::Atoi(*Args[0]) : 8;
+	const float WindowSecs = Args.Num() >= 2 ? FCString::Atof(*Args[1]) : 2.f;
+
+	if (!StartOverheadBenchmark(CameraCount, WindowSecs))
+	{
+		FUtilities::ShowNotification(TEXT("Overhead benchmark requires a game world."), false);
+	}
+}
 #pragma endregion
 
 #pragma region Capture Functions
@@ -216,12 +728,20 @@ void FBatchProfilerModule::StartRenderDocCommand(const TArray<FString>& Args, co
  */
 bool FBatchProfilerModule::TryInitCapture(const bool IsBatch)
 {
+	BATCHPROFILER_SCOPE(TryInitCapture);
 	if (ProfilingCameras.Num() == 0)
 	{
 		FUtilities::ShowNotification(TEXT("No active cameras found in world"), false);
 		return false;
 	}
 
+	const TArray<AProfilingCamera*> BatchCameras = GetBatchCameras();
+	if (IsBatch && BatchCameras.Num() == 0)
+	{
+		FUtilities::ShowNotification(TEXT("No cameras match the camera filter"), false);
+		return false;
+	}
+
 	// Execute Resolution Command
 	if (BatchProfilerSettings->UseCustomResolution)
 	{
@@ -237,11 +757,18 @@ bool FBatchProfilerModule::TryInitCapture(const bool IsBatch)
 		FUtilities::ExecuteCommand(Command);
 	}
 
+	// Start a new set of capture summaries
+	CaptureSummaries.Reset();
+	for (const TSharedRef<ICaptureCollector>& Collector : CaptureCollectors)
+	{
+		Collector->BeginBatch();
+	}
+
 	if (IsBatch)
 	{
         // If batch, start from first Profiling Camera
-		ActiveCamera = ProfilingCameras[0];
-		CurrentCameraIndex = 0;
+		ActiveCamera = BatchCameras[0];
+		CurrentCameraIndex = ProfilingCameras.IndexOfByKey(ActiveCamera);
 	}
 	else
 	{
@@ -262,8 +789,14 @@ bool FBatchProfilerModule::TryInitCapture(const bool IsBatch)
  * @param IsBatch Defines is batch run or single camera capture
  * @param IsSnapshot Captures using snapshot instead of trace
  */
-void FBatchProfilerModule::CaptureWithInsight(const float CaptureSecs, const bool IsBatch, const bool IsSnapshot) const
+void FBatchProfilerModule::CaptureWithInsight(const float CaptureSecs, const bool IsBatch, const bool IsSnapshot)
 {
+	if (IsBatch && BatchCheckpoint.IsActive())
+	{
+		BatchCheckpoint.BeginCamera(ActiveCamera->CameraName);
+		CameraDeadline = FPlatformTime::Seconds() + BatchProfilerSettings->DelayBeforeEachCapture + CaptureSecs + BatchProfilerSettings->StalledCaptureGraceSeconds;
+	}
+
 	ActiveCamera->StartInsightCapture(CaptureSecs, IsBatch, IsSnapshot);
 }
 
@@ -272,13 +805,26 @@ void FBatchProfilerModule::CaptureWithInsight(const float CaptureSecs, const boo
  * @param FrameCount How many frames to capture
  * @param IsBatch Defines is batch run or single camera capture
  */
-void FBatchProfilerModule::CaptureWithRenderDoc(const int FrameCount, const bool IsBatch) const
+void FBatchProfilerModule::CaptureWithRenderDoc(const int FrameCount, const bool IsBatch)
 {
+	if (IsBatch && BatchCheckpoint.IsActive())
+	{
+		BatchCheckpoint.BeginCamera(ActiveCamera->CameraName);
+		CameraDeadline = FPlatformTime::Seconds() + BatchProfilerSettings->DelayBeforeEachCapture + 1.0 + BatchProfilerSettings->StalledCaptureGraceSeconds;
+	}
+
 	ActiveCamera->StartRenderDoc(FrameCount, IsBatch);
 }
 
-void FBatchProfilerModule::CompleteCapture() const
+void FBatchProfilerModule::CompleteCapture()
 {
+	BATCHPROFILER_SCOPE(CompleteCapture);
+	StopWatchdog();
+	CameraDeadline = 0.0;
+	BatchCheckpoint.Finish();
+
+	WriteCaptureSummary();
+
 	// Execute Pre-Capture Commands	
 	for (const FString& Command : BatchProfilerSettings->PostCaptureCommands)
 	{
@@ -289,6 +835,398 @@ void FBatchProfilerModule::CompleteCapture() const
 	
 	UE_LOG(LogTemp, Warning, TEXT("Capture Complete"));
 	FUtilities::ShowNotification(TEXT("Capture Complete"), true);
+
+	CaptureCompleteDelegate.Broadcast();
+}
+#pragma endregion
+
+#pragma region Batch Recovery
+/**
+ * Starts checkpointing the batch, resumes from the last checkpoint when requested and the checkpoint matches the batch
+ * @param Backend Capture backend of the batch
+ * @param CaptureValue Capture seconds or frame count of the batch
+ * @return If cameras are left to capture
+ */
+bool FBatchProfilerModule::BeginCheckpoint(const EProfilingCaptureBackend Backend, const float CaptureValue)
+{
+	// Batches of a map batch resume the progress the map batch kept for their map
+	const bool bResumeRequested = ResumeRequested || MapBatchIndex != INDEX_NONE || FParse::Param(FCommandLine::Get(), TEXT("BatchProfilerResume"));
+	ResumeRequested = false;
+
+	if (!BatchProfilerSettings->WriteBatchCheckpoints)
+	{
+		return true;
+	}
+
+	const FString MapName = UWorld::RemovePIEPrefix(ActiveCamera->GetWorld()->GetOutermost()->GetName());
+	bool bResume = false;
+	if (bResumeRequested && BatchCheckpoint.Load())
+	{
+		bResume = BatchCheckpoint.GetMap() == MapName && BatchCheckpoint.GetBackend() == Backend;
+		if (!bResume && !BatchCheckpoint.GetMap().IsEmpty() && MapBatchIndex == INDEX_NONE)
+		{
+			// The checkpoint belongs to another batch, it is kept for that batch and this one runs without checkpoints
+			UE_LOG(LogTemp, Warning, TEXT("Checkpoint of %s does not match the batch, running without checkpoints"), *BatchCheckpoint.GetMap());
+			return true;
+		}
+	}
+
+	BatchCheckpoint.Begin(MapName, Backend, CaptureValue, bResume, MapBatchFile, MapBatchIndex);
+	WatchdogHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FBatchProfilerModule::WatchdogTick));
+	if (BatchProfilerSettings->HungGameThreadSeconds > 0.f)
+	{
+		BatchWatchdog = MakeUnique<FBatchWatchdog>(BatchProfilerSettings->HungGameThreadSeconds);
+	}
+
+	if (bResume)
+	{
+		// Merge results of the previous run and continue from the first camera it did not process
+		CaptureSummaries.Append(BatchCheckpoint.GetSummaries());
+
+		AProfilingCamera* const* FirstCamera = GetBatchCameras().FindByPredicate([this](const AProfilingCamera* Camera)
+		{
+			return !BatchCheckpoint.IsCameraProcessed(Camera->CameraName);
+		});
+
+		ActiveCamera = FirstCamera ? *FirstCamera : nullptr;
+		CurrentCameraIndex = ProfilingCameras.IndexOfByKey(ActiveCamera);
+		UE_LOG(LogTemp, Display, TEXT("Resuming batch with %d captured cameras"), CaptureSummaries.Num());
+	}
+
+	return ActiveCamera != nullptr;
+}
+
+bool FBatchProfilerModule::WatchdogTick(float DeltaTime)
+{
+	BATCHPROFILER_SCOPE(WatchdogTick);
+	if (BatchWatchdog.IsValid())
+	{
+		BatchWatchdog->Heartbeat();
+	}
+
+	if (CameraDeadline > 0.0 && FPlatformTime::Seconds() > CameraDeadline)
+	{
+		HandleStalledCapture();
+	}
+
+	return true;
+}
+
+void FBatchProfilerModule::StopWatchdog()
+{
+	if (WatchdogHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(WatchdogHandle);
+		WatchdogHandle.Reset();
+	}
+
+	BatchWatchdog.Reset();
+}
+
+/**
+ * Records the stalled camera as failed, cancels its pending capture and continues with the next camera
+ */
+void FBatchProfilerModule::HandleStalledCapture()
+{
+	CameraDeadline = 0.0;
+
+	if (ActiveCamera)
+	{
+		ActiveCamera->CancelCapture();
+		BatchCheckpoint.FailCamera(ActiveCamera->CameraName, TEXT("Stalled"));
+	}
+
+	AbortCaptureWindow();
+
+	const EProfilingCaptureBackend Backend = BatchCheckpoint.GetBackend();
+	if (Backend == EProfilingCaptureBackend::Trace)
+	{
+		FUtilities::ExecuteCommand("trace.stop");
+	}
+
+	if (GetNextCamera() == nullptr)
+	{
+		CompleteCapture();
+		return;
+	}
+
+	if (Backend == EProfilingCaptureBackend::RenderDoc)
+	{
+		CaptureWithRenderDoc(static_cast<int>(BatchCheckpoint.GetCaptureValue()), true);
+	}
+	else
+	{
+		CaptureWithInsight(BatchCheckpoint.GetCaptureValue(), true, Backend == EProfilingCaptureBackend::Snapshot);
+	}
+}
+#pragma endregion
+
+#pragma region Batch Control
+/**
+ * Starts the overhead benchmark, its result is available from GetOverheadBenchmark once it is no longer running
+ * @param CameraCount Number of synthetic cameras
+ * @param WindowSecs Capture window of each camera
+ * @return If the benchmark is started
+ */
+bool FBatchProfilerModule::StartOverheadBenchmark(const int32 CameraCount, const float WindowSecs)
+{
+	if (OverheadBenchmark.IsValid() && OverheadBenchmark->IsRunning())
+	{
+		return false;
+	}
+
+	// Benchmark cameras are not registered, the batch starts without TryInitCapture
+	CaptureSummaries.Reset();
+	for (const TSharedRef<ICaptureCollector>& Collector : CaptureCollectors)
+	{
+		Collector->BeginBatch();
+	}
+
+	FSlateNotificationManager::Get().SetAllowNotifications(false);
+
+	OverheadBenchmark = MakeUnique<FOverheadBenchmark>(*this, CameraCount, WindowSecs);
+	if (!OverheadBenchmark->Start(FSimpleDelegate::CreateRaw(this, &FBatchProfilerModule::CompleteCapture)))
+	{
+		FSlateNotificationManager::Get().SetAllowNotifications(true);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Map batch and map of the batches that are started, they are saved to the checkpoint so the map batch can be resumed
+ * @param CameraSetFile Camera set file of the map batch, empty when no map batch is running
+ * @param MapIndex Index of the current map in the camera set file
+ */
+void FBatchProfilerModule::SetMapBatchProgress(const FString& CameraSetFile, const int32 MapIndex)
+{
+	MapBatchFile = CameraSetFile;
+	MapBatchIndex = MapIndex;
+}
+
+/**
+ * Stops the running batch without completing it, the checkpoint is kept so the batch can be resumed
+ */
+void FBatchProfilerModule::CancelBatch()
+{
+	StopWatchdog();
+	CameraDeadline = 0.0;
+
+	if (ActiveCamera)
+	{
+		ActiveCamera->CancelCapture();
+	}
+	AbortCaptureWindow();
+
+	// A trace of the cancelled camera may still be recording
+	FUtilities::ExecuteCommand("trace.stop");
+	FSlateNotificationManager::Get().SetAllowNotifications(true);
+
+	UE_LOG(LogTemp, Warning, TEXT("Capture Cancelled"));
+}
+
+/**
+ * Starts a batch capture on every camera passing the camera filter
+ * @param Backend Capture backend
+ * @param CaptureValue Capture seconds (UE Insights) or frame count (RenderDoc), uses settings if zero
+ * @return If the batch is started, OnCaptureComplete is broadcast when it ends
+ */
+bool FBatchProfilerModule::StartBatch(const EProfilingCaptureBackend Backend, const float CaptureValue)
+{
+	if (GetBatchCameras().Num() == 0)
+	{
+		return false;
+	}
+
+	TArray<FString> Args;
+	if (CaptureValue > 0.f)
+	{
+		Args.Add(FString::SanitizeFloat(CaptureValue));
+	}
+
+	switch (Backend)
+	{
+	case EProfilingCaptureBackend::Trace:
+		StartInsightCommand(Args, true, false);
+		break;
+
+	case EProfilingCaptureBackend::Snapshot:
+		StartInsightCommand(Args, true, true);
+		break;
+
+	case EProfilingCaptureBackend::RenderDoc:
+#if PLATFORM_WINDOWS || PLATFORM_LINUX
+		StartRenderDocCommand(Args, true);
+		break;
+#else
+		return false;
+#endif
+
+	case EProfilingCaptureBackend::StaticCost:
+		AnalyzeStaticCostCommand(TArray<FString>());
+		CaptureCompleteDelegate.Broadcast();
+		break;
+	}
+
+	return true;
+}
+
+/**
+ * Limits batches to the cameras with the given names, an empty filter includes every camera
+ * @param CameraNames Names of the cameras to include
+ */
+void FBatchProfilerModule::SetCameraFilter(const TArray<FString>& CameraNames)
+{
+	CameraFilter = CameraNames;
+}
+
+/**
+ * Returns the registered cameras included by the camera filter, in registration order
+ */
+TArray<AProfilingCamera*> FBatchProfilerModule::GetBatchCameras() const
+{
+	if (CameraFilter.Num() == 0)
+	{
+		return ProfilingCameras;
+	}
+
+	return ProfilingCameras.FilterByPredicate([this](const AProfilingCamera* Camera)
+	{
+		return CameraFilter.Contains(Camera->CameraName);
+	});
+}
+#pragma endregion
+
+#pragma region Capture Window
+/**
+ * Lets collectors prepare before the view is moved to a camera
+ * @param Camera Camera the view is moved to
+ */
+void FBatchProfilerModule::BeginCameraArrival(const AProfilingCamera* Camera)
+{
+	BATCHPROFILER_SCOPE(BeginCameraArrival);
+	for (const TSharedRef<ICaptureCollector>& Collector : CaptureCollectors)
+	{
+		Collector->BeginArrival(Camera);
+	}
+}
+
+/**
+ * Starts recording frame stats and collectors when the capture of a camera starts
+ * @param Camera Captured camera
+ */
+void FBatchProfilerModule::BeginCaptureWindow(const AProfilingCamera* Camera)
+{
+	BATCHPROFILER_SCOPE(BeginCaptureWindow);
+	for (const TSharedRef<ICaptureCollector>& Collector : CaptureCollectors)
+	{
+		Collector->BeginCapture(Camera);
+	}
+
+	CaptureFrameRecorder.Start();
+}
+
+/**
+ * Stops recording and stores the summary of the camera
+ * @param Camera Captured camera
+ */
+void FBatchProfilerModule::EndCaptureWindow(const AProfilingCamera* Camera)
+{
+	BATCHPROFILER_SCOPE(EndCaptureWindow);
+	if (!CaptureFrameRecorder.IsRecording())
+	{
+		return;
+	}
+
+	FCameraCaptureSummary& Summary = CaptureSummaries.AddDefaulted_GetRef();
+	Summary.CameraName = Camera->CameraName;
+	Summary.FrameStats = CaptureFrameRecorder.Stop();
+
+	if (Camera->FrameBudgetMs > 0.f)
+	{
+		Summary.AddMetric(TEXT("FrameBudgetMs"), Camera->FrameBudgetMs);
+		Summary.AddMetric(TEXT("OverBudgetMs"), Summary.FrameStats.AvgFrameMs - Camera->FrameBudgetMs);
+	}
+
+	for (const TSharedRef<ICaptureCollector>& Collector : CaptureCollectors)
+	{
+		Collector->EndCapture(Summary);
+	}
+}
+
+/**
+ * Discards the capture window of a camera that did not finish
+ */
+void FBatchProfilerModule::AbortCaptureWindow()
+{
+	if (!CaptureFrameRecorder.IsRecording())
+	{
+		return;
+	}
+
+	CaptureFrameRecorder.Stop();
+
+	// Collectors still need to stop, their measurements are not reported
+	FCameraCaptureSummary DiscardedSummary;
+	for (const TSharedRef<ICaptureCollector>& Collector : CaptureCollectors)
+	{
+		Collector->EndCapture(DiscardedSummary);
+	}
+}
+
+/**
+ * Writes frame stats and collector metrics of each captured camera as csv, then lets collectors write their reports
+ */
+void FBatchProfilerModule::WriteCaptureSummary() const
+{
+	BATCHPROFILER_SCOPE(WriteCaptureSummary);
+	if (CaptureSummaries.Num() == 0)
+	{
+		return;
+	}
+
+	// Collectors may be toggled between cameras, so gather every metric name
+	TArray<FString> MetricNames;
+	for (const FCameraCaptureSummary& Summary : CaptureSummaries)
+	{
+		for (const TPair<FString, double>& Metric : Summary.Metrics)
+		{
+			MetricNames.AddUnique(Metric.Key);
+		}
+	}
+
+	FString Report = TEXT("Camera,Frames,AvgFrameMs,P95FrameMs,MaxFrameMs,GameThreadMs,RenderThreadMs,GPUMs");
+	for (const FString& MetricName : MetricNames)
+	{
+		Report += TEXT(",") + MetricName;
+	}
+	Report += TEXT("\n");
+
+	for (const FCameraCaptureSummary& Summary : CaptureSummaries)
+	{
+		const FFrameStats& Stats = Summary.FrameStats;
+		Report += FString::Printf(TEXT("%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f"), *Summary.CameraName, Stats.FrameCount,
+			Stats.AvgFrameMs, Stats.P95FrameMs, Stats.MaxFrameMs, Stats.AvgGameThreadMs, Stats.AvgRenderThreadMs, Stats.AvgGPUMs);
+
+		for (const FString& MetricName : MetricNames)
+		{
+			const TPair<FString, double>* Metric = Summary.Metrics.FindByPredicate([&MetricName](const TPair<FString, double>& Item)
+			{
+				return Item.Key == MetricName;
+			});
+			Report += Metric ? FString::Printf(TEXT(",%.4f"), Metric->Value) : FString(TEXT(","));
+		}
+		Report += TEXT("\n");
+	}
+
+	const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y.%m.%d_%H.%M"));
+	FUtilities::SaveReport(FString::Printf(TEXT("CaptureSummary_%s.csv"), *Timestamp), Report);
+
+	for (const TSharedRef<ICaptureCollector>& Collector : CaptureCollectors)
+	{
+		Collector->CompleteBatch(CaptureSummaries);
+	}
 }
 #pragma endregion
 
@@ -327,8 +1265,28 @@ void FBatchProfilerModule::UnregisterProfilingCamera(AProfilingCamera* Profiling
 		{
 			CurrentCameraIndex = ProfilingCameras.Num() - 1; // Set to the latest index
 		}
+
+		// Do not keep a dangling active camera when its world is torn down (ie. map or replay load)
+		if (ActiveCamera == ProfilingCamera)
+		{
+			ActiveCamera = ProfilingCameras.IsValidIndex(CurrentCameraIndex) ? ProfilingCameras[CurrentCameraIndex] : nullptr;
+		}
 	}
 }
+
+/**
+ * @brief Finds a registered ProfilingCamera by its camera name
+ * @return Camera or null if no camera with the name is registered
+ */
+AProfilingCamera* FBatchProfilerModule::FindProfilingCamera(const FString& CameraName) const
+{
+	AProfilingCamera* const* Camera = ProfilingCameras.FindByPredicate([&CameraName](const AProfilingCamera* ProfilingCamera)
+	{
+		return ProfilingCamera->CameraName == CameraName;
+	});
+
+	return Camera ? *Camera : nullptr;
+}
 #pragma endregion
 
 #pragma region Camera Switch & Caches
@@ -381,6 +1339,7 @@ void FBatchProfilerModule::PreviousCamera()
  */
 AProfilingCamera* FBatchProfilerModule::GetNextCamera()
 {
+	BATCHPROFILER_SCOPE(GetNextCamera);
 	// No cameras or invalid index
 	if (ProfilingCameras.Num() == 0 || CurrentCameraIndex < 0)
 	{
@@ -390,7 +1349,23 @@ AProfilingCamera* FBatchProfilerModule::GetNextCamera()
 		return nullptr;
 	}
 
-	const int32 NextIndex = CurrentCameraIndex + 1;
+	// The camera is done, save progress before moving on
+	if (ActiveCamera && BatchCheckpoint.IsActive())
+	{
+		const bool bHasSummary = CaptureSummaries.Num() > 0 && CaptureSummaries.Last().CameraName == ActiveCamera->CameraName;
+		BatchCheckpoint.CompleteCamera(ActiveCamera->CameraName, bHasSummary ? &CaptureSummaries.Last() : nullptr);
+		CameraDeadline = 0.0;
+	}
+
+	// Skip cameras excluded by the camera filter or processed before the batch was resumed
+	int32 NextIndex = CurrentCameraIndex + 1;
+	const TArray<AProfilingCamera*> BatchCameras = GetBatchCameras();
+	while (NextIndex < ProfilingCameras.Num()
+		&& (!BatchCameras.Contains(ProfilingCameras[NextIndex]) || BatchCheckpoint.IsCameraProcessed(ProfilingCameras[NextIndex]->CameraName)))
+	{
+		NextIndex++;
+	}
+
 	if (NextIndex < ProfilingCameras.Num())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Getting camera %i"), NextIndex);
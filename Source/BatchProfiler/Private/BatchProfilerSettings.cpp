@@ -16,6 +16,7 @@ UBatchProfilerSettings::UBatchProfilerSettings(const FObjectInitializer& ObjectI
 	UseCustomResolution = false;
 	UseFullscreen = true;
 	CaptureResolution = FIntPoint(1920, 1080);
+	ShowCameraNameOnScreen = true;
 	
 	// UE Insights settings
 	InsightsFilenameTokens = TEXT("{CameraName}_{Year}.{Month}.{Day}_{Hour}.{Minute}");
@@ -23,7 +24,50 @@ UBatchProfilerSettings::UBatchProfilerSettings(const FObjectInitializer& ObjectI
 
 	// UE Insights Trace settings
 	TraceSettings.InsightsCaptureSeconds = 5.0f;
+	TraceSettings.CalibrationSeconds = 5.0f;
 	
 	// RenderDoc Settings
 	RenderDocFrameCaptureCount = 1;
+
+	// Capture Analysis Settings
+	AttributeTickCost = false;
+	TickCostTopCount = 20;
+	MeasureThreadOccupancy = true;
+	MeasureColdArrival = false;
+	ReadPerfCounters = false;
+	MeasureGarbageCollection = false;
+	ForceGarbageCollectionBeforeCapture = false;
+	ChurnTopClassCount = 10;
+	WriteFrameTelemetry = true;
+
+	// Static Cost Settings
+	StaticCostTopPrimitiveCount = 20;
+
+	// Experiment Settings
+	ExperimentRounds = 10;
+	ExperimentSettleSeconds = 0.5f;
+	ExperimentWindowSeconds = 1.0f;
+
+	// Load Sweep Settings
+	SweepCounts = { 0, 8, 16, 32, 64, 128 };
+	SweepSpawnDistance = 1500.0f;
+	SweepSpawnRadius = 1000.0f;
+	SweepSettleSeconds = 2.0f;
+	SweepWindowSeconds = 2.0f;
+
+	// Replay Settings
+	ReplayStartSeconds = 0.0f;
+	ReplayDurationSeconds = 10.0f;
+	TraceReplayCaptures = false;
+
+	// Batch Recovery Settings
+	WriteBatchCheckpoints = true;
+	StalledCaptureGraceSeconds = 30.0f;
+	HungGameThreadSeconds = 300.0f;
+
+	// Benchmark Settings
+	OverheadNoiseThresholdMs = 0.05f;
+
+	// Map Batch Settings
+	CameraSetFile = TEXT("");
 }
@@ -0,0 +1,320 @@
+#include "Benchmark/OverheadBenchmark.h"
+#include "BatchProfiler.h"
+#include "BatchProfilerSettings.h"
+#include "ProfilingCamera.h"
+#include "Engine/World.h"
+#include "Utilities/ProfilerStats.h"
+#include "Utilities/Utilities.h"
+
+namespace OverheadBenchmark
+{
+	// Cameras are lined up so every switch moves the view
+	static constexpr float CameraSpacing = 1000.f;
+
+	// Standard errors of the frame time difference treated as noise, about 95% confidence
+	static constexpr double NoiseStandardErrors = 2.0;
+}
+
+FOverheadBenchmark::FOverheadBenchmark(FBatchProfilerModule& InProfilerModule, const int32 InCameraCount, const float InWindowSecs)
+	: ProfilerModule(InProfilerModule), CameraCount(FMath::Max(InCameraCount, 1)), WindowSecs(FMath::Max(InWindowSecs, 0.1f))
+{
+}
+
+FOverheadBenchmark::~FOverheadBenchmark()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		BaselineRecorder.Stop();
+		DestroyCameras();
+		RestoreTickCostSetting();
+	}
+}
+
+/**
+ * @brief Spawns transient cameras and measures the baseline frame time without plugin work
+ * @param InOnComplete Called after the report is written
+ * @return If the benchmark is started
+ */
+bool FOverheadBenchmark::Start(const FSimpleDelegate& InOnComplete)
+{
+	UWorld* World = FUtilities::GetGameWorld();
+	if (World == nullptr)
+	{
+		return false;
+	}
+
+	for (int32 Index = 0; Index < CameraCount; ++Index)
+	{
+		const FTransform Transform(FRotator::ZeroRotator, FVector(Index * OverheadBenchmark::CameraSpacing, 0.f, 200.f));
+		AProfilingCamera* Camera = World->SpawnActorDeferred<AProfilingCamera>(AProfilingCamera::StaticClass(), Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (Camera)
+		{
+			// Not registered, the benchmark must not leak into regular batches
+			Camera->SetFlags(RF_Transient);
+			Camera->CameraName = FString::Printf(TEXT("Benchmark%02d"), Index);
+			Camera->IsActiveOnProfiling = false;
+			Camera->FinishSpawning(Transform);
+			Cameras.Add(Camera);
+		}
+	}
+
+	if (Cameras.Num() == 0)
+	{
+		return false;
+	}
+
+	OnComplete = InOnComplete;
+	SwitchOverheadSecs = 0.0;
+	BatchPass = FPassStats();
+	TickCostPass = FPassStats();
+	bPassed = false;
+	ResultText.Reset();
+
+	// The overhead of the plugin is measured without the opt-in tick cost attribution
+	UBatchProfilerSettings* BatchProfilerSettings = GetMutableDefault<UBatchProfilerSettings>();
+	bOriginalAttributeTickCost = BatchProfilerSettings->AttributeTickCost;
+	BatchProfilerSettings->AttributeTickCost = false;
+	bIsTickCostPass = false;
+
+	// Baseline covers as many frames as the batch windows
+	Phase = EPhase::Baseline;
+	PhaseEndTime = FPlatformTime::Seconds() + WindowSecs * Cameras.Num();
+	BaselineRecorder.Start();
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FOverheadBenchmark::Tick));
+
+	return true;
+}
+
+bool FOverheadBenchmark::Tick(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	if (Now < PhaseEndTime)
+	{
+		return true;
+	}
+
+	switch (Phase)
+	{
+	case EPhase::Baseline:
+		BaselineStats = BaselineRecorder.Stop();
+		CameraIndex = 0;
+		StartCamera();
+		break;
+
+	case EPhase::Arrive:
+		WindowStartOverhead = FProfilerOverhead::GetSeconds();
+		Phase = EPhase::Capture;
+		PhaseEndTime = Now + WindowSecs;
+		break;
+
+	case EPhase::Capture:
+		FinishCamera();
+		break;
+	}
+
+	if (CameraIndex >= Cameras.Num() && !StartTickCostPass())
+	{
+		TickerHandle.Reset();
+		DestroyCameras();
+		RestoreTickCostSetting();
+		WriteReport();
+		OnComplete.ExecuteIfBound();
+		return false;
+	}
+
+	return true;
+}
+
+#pragma region Synthetic Batch
+/**
+ * @brief Runs the camera switch path of a batch without a capture backend
+ */
+void FOverheadBenchmark::StartCamera()
+{
+	AProfilingCamera* Camera = Cameras[CameraIndex].Get();
+	if (Camera == nullptr)
+	{
+		CameraIndex++;
+		return;
+	}
+
+	const double SwitchStartOverhead = FProfilerOverhead::GetSeconds();
+	ProfilerModule.BeginCameraArrival(Camera);
+	Camera->ActivateCamera();
+	Camera->GetFilename();
+	ProfilerModule.BeginCaptureWindow(Camera);
+	SwitchOverheadSecs += FProfilerOverhead::GetSeconds() - SwitchStartOverhead;
+
+	// The capture delay is not needed on an empty map, the window starts on the next tick
+	Phase = EPhase::Arrive;
+	PhaseEndTime = 0.0;
+}
+
+/**
+ * @brief Ends the capture window and accumulates plugin time spent inside it
+ */
+void FOverheadBenchmark::FinishCamera()
+{
+	FPassStats& Pass = bIsTickCostPass ? TickCostPass : BatchPass;
+	Pass.OverheadSecs += FProfilerOverhead::GetSeconds() - WindowStartOverhead;
+
+	const double SwitchStartOverhead = FProfilerOverhead::GetSeconds();
+	if (const AProfilingCamera* Camera = Cameras[CameraIndex].Get())
+	{
+		ProfilerModule.EndCaptureWindow(Camera);
+	}
+
+	// Switch overhead is reported for the regular batch only
+	if (!bIsTickCostPass)
+	{
+		SwitchOverheadSecs += FProfilerOverhead::GetSeconds() - SwitchStartOverhead;
+	}
+
+	const TArray<FCameraCaptureSummary>& Summaries = ProfilerModule.GetCaptureSummaries();
+	if (Summaries.Num() > 0)
+	{
+		const FFrameStats& Stats = Summaries.Last().FrameStats;
+		Pass.Frames += Stats.FrameCount;
+		Pass.FrameMsSum += Stats.AvgFrameMs * Stats.FrameCount;
+		Pass.FrameMsSquareSum += (FMath::Square(Stats.StdDevFrameMs) + FMath::Square(Stats.AvgFrameMs)) * Stats.FrameCount;
+	}
+
+	if (++CameraIndex < Cameras.Num())
+	{
+		StartCamera();
+	}
+}
+
+/**
+ * @brief Runs the cameras again with tick cost attribution on, once after the regular batch and only in stats builds
+ * @return If the pass is started
+ */
+bool FOverheadBenchmark::StartTickCostPass()
+{
+#if STATS
+	if (!bIsTickCostPass)
+	{
+		bIsTickCostPass = true;
+		GetMutableDefault<UBatchProfilerSettings>()->AttributeTickCost = true;
+		CameraIndex = 0;
+		StartCamera();
+		return CameraIndex < Cameras.Num();
+	}
+#endif
+
+	return false;
+}
+
+void FOverheadBenchmark::RestoreTickCostSetting()
+{
+	GetMutableDefault<UBatchProfilerSettings>()->AttributeTickCost = bOriginalAttributeTickCost;
+}
+
+void FOverheadBenchmark::DestroyCameras()
+{
+	for (const TWeakObjectPtr<AProfilingCamera>& Camera : Cameras)
+	{
+		if (Camera.IsValid())
+		{
+			Camera->Destroy();
+		}
+	}
+
+	Cameras.Reset();
+}
+#pragma endregion
+
+#pragma region Report
+double FOverheadBenchmark::FPassStats::GetAvgFrameMs() const
+{
+	return Frames > 0 ? FrameMsSum / Frames : 0.0;
+}
+
+double FOverheadBenchmark::FPassStats::GetFrameVariance() const
+{
+	return Frames > 0 ? FMath::Max(FrameMsSquareSum / Frames - FMath::Square(GetAvgFrameMs()), 0.0) : 0.0;
+}
+
+/**
+ * @brief Writes plugin time per frame and per camera next to baseline and batch frame times and evaluates the result
+ */
+void FOverheadBenchmark::WriteReport()
+{
+	const float ThresholdMs = GetDefault<UBatchProfilerSettings>()->OverheadNoiseThresholdMs;
+	const double PluginMsPerFrame = BatchPass.Frames > 0 ? BatchPass.OverheadSecs * 1000.0 / BatchPass.Frames : 0.0;
+	const double PluginMsPerCamera = CameraCount > 0 ? SwitchOverheadSecs * 1000.0 / CameraCount : 0.0;
+	const double BatchFrameMs = BatchPass.GetAvgFrameMs();
+	const double FrameDeltaMs = BatchFrameMs - BaselineStats.AvgFrameMs;
+
+	// Standard error of the difference of the two mean frame times
+	const double FrameDeltaError = FMath::Sqrt(
+		(BatchPass.Frames > 0 ? BatchPass.GetFrameVariance() / BatchPass.Frames : 0.0) +
+		(BaselineStats.FrameCount > 0 ? FMath::Square(BaselineStats.StdDevFrameMs) / BaselineStats.FrameCount : 0.0));
+	const double FrameNoiseMs = FrameDeltaError * OverheadBenchmark::NoiseStandardErrors;
+
+	// Plugin timers miss work the plugin causes elsewhere, a frame time increase beyond noise fails as well
+	const bool bPluginTimePassed = PluginMsPerFrame <= ThresholdMs;
+	const bool bFrameDeltaPassed = FrameDeltaMs <= ThresholdMs + FrameNoiseMs;
+	bPassed = BatchPass.Frames > 0 && bPluginTimePassed && bFrameDeltaPassed;
+
+	if (BatchPass.Frames == 0)
+	{
+		ResultText = TEXT("No frames were captured");
+	}
+	else if (!bPluginTimePassed)
+	{
+		ResultText = FString::Printf(TEXT("Profiler overhead %.5f ms per frame exceeds %.5f ms"), PluginMsPerFrame, ThresholdMs);
+	}
+	else if (!bFrameDeltaPassed)
+	{
+		ResultText = FString::Printf(TEXT("Frame time increase %.5f ms exceeds %.5f ms with %.5f ms noise"), FrameDeltaMs, ThresholdMs, FrameNoiseMs);
+	}
+	else
+	{
+		ResultText = FString::Printf(TEXT("Profiler overhead %.5f ms per frame, %.5f ms per camera"), PluginMsPerFrame, PluginMsPerCamera);
+	}
+
+	FString Report = TEXT("Metric,Value\n");
+	Report += FString::Printf(TEXT("Cameras,%d\n"), CameraCount);
+	Report += FString::Printf(TEXT("WindowSecs,%.2f\n"), WindowSecs);
+	Report += FString::Printf(TEXT("BaselineFrames,%d\n"), BaselineStats.FrameCount);
+	Report += FString::Printf(TEXT("BaselineFrameMs,%.4f\n"), BaselineStats.AvgFrameMs);
+	Report += FString::Printf(TEXT("BatchFrames,%d\n"), BatchPass.Frames);
+	Report += FString::Printf(TEXT("BatchFrameMs,%.4f\n"), BatchFrameMs);
+	Report += FString::Printf(TEXT("FrameDeltaMs,%.4f\n"), FrameDeltaMs);
+	Report += FString::Printf(TEXT("FrameNoiseMs,%.4f\n"), FrameNoiseMs);
+	Report += FString::Printf(TEXT("PluginMsPerFrame,%.5f\n"), PluginMsPerFrame);
+	Report += FString::Printf(TEXT("PluginMsPerCamera,%.5f\n"), PluginMsPerCamera);
+	Report += FString::Printf(TEXT("ThresholdMs,%.5f\n"), ThresholdMs);
+	Report += FString::Printf(TEXT("Result,%s\n"), bPassed ? TEXT("Passed") : TEXT("Failed"));
+
+	// Tick cost attribution enables per object cycle stats, its cost is reported against the regular batch and does not fail the benchmark
+	if (TickCostPass.Frames > 0)
+	{
+		const double TickCostFrameDeltaMs = TickCostPass.GetAvgFrameMs() - BatchFrameMs;
+		const double TickCostNoiseMs = OverheadBenchmark::NoiseStandardErrors * FMath::Sqrt(
+			(BatchPass.Frames > 0 ? BatchPass.GetFrameVariance() / BatchPass.Frames : 0.0) +
+			TickCostPass.GetFrameVariance() / TickCostPass.Frames);
+
+		Report += FString::Printf(TEXT("TickCostFrames,%d\n"), TickCostPass.Frames);
+		Report += FString::Printf(TEXT("TickCostFrameMs,%.4f\n"), TickCostPass.GetAvgFrameMs());
+		Report += FString::Printf(TEXT("TickCostFrameDeltaMs,%.4f\n"), TickCostFrameDeltaMs);
+		Report += FString::Printf(TEXT("TickCostFrameNoiseMs,%.4f\n"), TickCostNoiseMs);
+		Report += FString::Printf(TEXT("TickCostPluginMsPerFrame,%.5f\n"), TickCostPass.OverheadSecs * 1000.0 / TickCostPass.Frames);
+		UE_LOG(LogTemp, Display, TEXT("Tick cost attribution adds %.4f ms per frame with %.4f ms noise"), TickCostFrameDeltaMs, TickCostNoiseMs);
+	}
+
+	const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y.%m.%d_%H.%M"));
+	FUtilities::SaveReport(FString::Printf(TEXT("ProfilerOverhead_%s.csv"), *Timestamp), Report);
+
+	if (bPassed)
+	{
+		UE_LOG(LogTemp, Display, TEXT("%s"), *ResultText);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s"), *ResultText);
+	}
+}
+#pragma endregion
@@ -0,0 +1,88 @@
+#include "BatchProfiler.h"
+#include "Benchmark/OverheadBenchmark.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+#include "Utilities/Utilities.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace OverheadBenchmarkTest
+{
+	// Empty map, the benchmark measures the plugin and not the content
+	static const TCHAR* MapName = TEXT("/Engine/Maps/Entry");
+	static constexpr int32 CameraCount = 8;
+	static constexpr float WindowSecs = 2.f;
+}
+
+/**
+ * Starts the benchmark once the game world is available
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FStartOverheadBenchmarkCommand, FAutomationTestBase*, Test);
+bool FStartOverheadBenchmarkCommand::Update()
+{
+	FBatchProfilerModule& ProfilerModule = FModuleManager::GetModuleChecked<FBatchProfilerModule>("BatchProfiler");
+	if (!ProfilerModule.StartOverheadBenchmark(OverheadBenchmarkTest::CameraCount, OverheadBenchmarkTest::WindowSecs))
+	{
+		Test->AddError(TEXT("Overhead benchmark could not be started"));
+	}
+
+	return true;
+}
+
+/**
+ * Waits for the benchmark and fails the test when the benchmark failed
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FWaitForOverheadBenchmarkCommand, FAutomationTestBase*, Test);
+bool FWaitForOverheadBenchmarkCommand::Update()
+{
+	const FBatchProfilerModule& ProfilerModule = FModuleManager::GetModuleChecked<FBatchProfilerModule>("BatchProfiler");
+	const FOverheadBenchmark* OverheadBenchmark = ProfilerModule.GetOverheadBenchmark();
+	if (OverheadBenchmark == nullptr)
+	{
+		return true;
+	}
+
+	if (OverheadBenchmark->IsRunning())
+	{
+		return false;
+	}
+
+	if (OverheadBenchmark->HasPassed())
+	{
+		Test->AddInfo(OverheadBenchmark->GetResultText());
+	}
+	else
+	{
+		Test->AddError(OverheadBenchmark->GetResultText());
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBatchProfilerOverheadTest, "BatchProfiler.Overhead",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+/**
+ * Runs the overhead benchmark on an empty map, fails when the plugin exceeds the overhead noise threshold
+ */
+bool FBatchProfilerOverheadTest::RunTest(const FString& Parameters)
+{
+	const bool bOpensMap = FUtilities::GetGameWorld() == nullptr;
+	if (bOpensMap && !AutomationOpenMap(OverheadBenchmarkTest::MapName))
+	{
+		AddError(FString::Printf(TEXT("Could not open %s"), OverheadBenchmarkTest::MapName));
+		return false;
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FStartOverheadBenchmarkCommand(this));
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitForOverheadBenchmarkCommand(this));
+
+	if (bOpensMap && GIsEditor)
+	{
+		ADD_LATENT_AUTOMATION_COMMAND(FEndPlayMapCommand());
+	}
+
+	return true;
+}
+
+#endif
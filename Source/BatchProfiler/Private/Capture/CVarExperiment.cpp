@@ -0,0 +1,330 @@
+#include "Capture/CVarExperiment.h"
+#include "Utilities/ProfilerStats.h"
+#include "ProfilingCamera.h"
+#include "HAL/IConsoleManager.h"
+#include "Utilities/Utilities.h"
+
+namespace CVarExperiment
+{
+	static const TCHAR* MetricNames[] = { TEXT("FrameMs"), TEXT("GameThreadMs"), TEXT("RenderThreadMs"), TEXT("GPUMs") };
+
+	static float GetMetric(const FFrameStats& Stats, const int32 MetricIndex)
+	{
+		switch (MetricIndex)
+		{
+		case 0:		return Stats.AvgFrameMs;
+		case 1:		return Stats.AvgGameThreadMs;
+		case 2:		return Stats.AvgRenderThreadMs;
+		default:	return Stats.AvgGPUMs;
+		}
+	}
+
+	static FString GetCVarName(const FString& Command)
+	{
+		FString CVarName;
+		FString Value;
+		return Command.TrimStartAndEnd().Split(TEXT(" "), &CVarName, &Value) ? CVarName : Command.TrimStartAndEnd();
+	}
+}
+
+FCVarExperiment::FCVarExperiment(const TArray<AProfilingCamera*>& InCameras, const TArray<FBatchProfilerCVarSet>& InCVarSets, const int InRounds)
+	: Cameras(InCameras), CVarSets(InCVarSets), Rounds(FMath::Max(Align(InRounds, 2), 2))
+{
+	// Remember original values of every touched CVar so sets never leak into each other
+	for (const FBatchProfilerCVarSet& CVarSet : CVarSets)
+	{
+		for (const FString& Command : CVarSet.Commands)
+		{
+			const FString CVarName = CVarExperiment::GetCVarName(Command);
+			if (OriginalValues.Contains(CVarName))
+			{
+				continue;
+			}
+
+			if (const IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(*CVarName))
+			{
+				OriginalValues.Add(CVarName, CVar->GetString());
+			}
+			else
+			{
+				UE_LOG(LogTemp, Warning, TEXT("%s is not a console variable and will not be restored between sets"), *CVarName);
+			}
+		}
+	}
+
+	Results.SetNum(Cameras.Num());
+	for (TArray<TArray<FFrameStats>>& CameraResults : Results)
+	{
+		CameraResults.SetNum(CVarSets.Num());
+	}
+}
+
+FCVarExperiment::~FCVarExperiment()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		RestoreCVars();
+	}
+}
+
+/**
+ * @brief Starts the experiment from the first camera
+ * @param InOnComplete Called after the report is written
+ */
+void FCVarExperiment::Start(const FSimpleDelegate& InOnComplete)
+{
+	OnComplete = InOnComplete;
+	CameraIndex = 0;
+
+	StartCamera();
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FCVarExperiment::Tick));
+}
+
+bool FCVarExperiment::Tick(float DeltaTime)
+{
+	BATCHPROFILER_SCOPE(ExperimentTick);
+	const double Now = FPlatformTime::Seconds();
+	if (Now < PhaseEndTime)
+	{
+		return true;
+	}
+
+	switch (Phase)
+	{
+	case EPhase::Arrive:
+		StartWindow();
+		break;
+
+	case EPhase::Settle:
+		Recorder.Start();
+		Phase = EPhase::Measure;
+		PhaseEndTime = Now + GetDefault<UBatchProfilerSettings>()->ExperimentWindowSeconds;
+		break;
+
+	case EPhase::Measure:
+		FinishWindow();
+		break;
+	}
+
+	if (CameraIndex >= Cameras.Num())
+	{
+		TickerHandle.Reset();
+		WriteReport();
+		OnComplete.ExecuteIfBound();
+		return false;
+	}
+
+	return true;
+}
+
+#pragma region Windows
+/**
+ * @brief Moves the view to the current camera and waits for the capture delay
+ */
+void FCVarExperiment::StartCamera()
+{
+	AProfilingCamera* Camera = Cameras[CameraIndex];
+	UE_LOG(LogTemp, Warning, TEXT("Experimenting From: %s"), *Camera->CameraName);
+	Camera->ActivateCamera();
+
+	RoundIndex = 0;
+	OrderIndex = 0;
+	Phase = EPhase::Arrive;
+	PhaseEndTime = FPlatformTime::Seconds() + GetDefault<UBatchProfilerSettings>()->DelayBeforeEachCapture;
+}
+
+/**
+ * @brief Applies the current set and waits for it to settle
+ */
+void FCVarExperiment::StartWindow()
+{
+	ApplyCVarSet(GetSetIndex(RoundIndex, OrderIndex));
+	Phase = EPhase::Settle;
+	PhaseEndTime = FPlatformTime::Seconds() + GetDefault<UBatchProfilerSettings>()->ExperimentSettleSeconds;
+}
+
+/**
+ * @brief Stores the window result and advances set, round and camera
+ */
+void FCVarExperiment::FinishWindow()
+{
+	Results[CameraIndex][GetSetIndex(RoundIndex, OrderIndex)].Add(Recorder.Stop());
+
+	if (++OrderIndex < CVarSets.Num())
+	{
+		StartWindow();
+		return;
+	}
+
+	OrderIndex = 0;
+	if (++RoundIndex < Rounds)
+	{
+		StartWindow();
+		return;
+	}
+
+	RestoreCVars();
+	if (++CameraIndex < Cameras.Num())
+	{
+		StartCamera();
+	}
+}
+
+/**
+ * @brief Runs the sets forward in even rounds and backward in odd rounds (ABBA), so linear drift over a round pair
+ * lands equally on every set and cancels in the paired per round differences
+ * @param InRoundIndex Round of the window
+ * @param InOrderIndex Position of the window in the round
+ * @return Set measured at that position
+ */
+int32 FCVarExperiment::GetSetIndex(const int32 InRoundIndex, const int32 InOrderIndex) const
+{
+	return InRoundIndex % 2 == 0 ? InOrderIndex : CVarSets.Num() - 1 - InOrderIndex;
+}
+
+void FCVarExperiment::ApplyCVarSet(const int32 InSetIndex) const
+{
+	RestoreCVars();
+
+	for (const FString& Command : CVarSets[InSetIndex].Commands)
+	{
+		FUtilities::ExecuteCommand(Command);
+	}
+}
+
+void FCVarExperiment::RestoreCVars() const
+{
+	for (const TPair<FString, FString>& OriginalValue : OriginalValues)
+	{
+		FUtilities::ExecuteCommand(FString::Printf(TEXT("%s %s"), *OriginalValue.Key, *OriginalValue.Value));
+	}
+}
+#pragma endregion
+
+#pragma region Statistics
+/**
+ * @brief Computes the mean paired difference between a set and the baseline with a 95% confidence interval
+ * @param Baseline Baseline samples per round
+ * @param Samples Compared samples per round
+ * @return Paired delta
+ */
+FCVarExperiment::FPairedDelta FCVarExperiment::ComputePairedDelta(const TArray<float>& Baseline, const TArray<float>& Samples)
+{
+	FPairedDelta Delta;
+	const int32 Count = FMath::Min(Baseline.Num(), Samples.Num());
+	if (Count == 0)
+	{
+		return Delta;
+	}
+
+	double DifferenceSum = 0.0;
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		Delta.BaselineMean += Baseline[Index];
+		DifferenceSum += Samples[Index] - Baseline[Index];
+	}
+	Delta.BaselineMean /= Count;
+	Delta.Mean = DifferenceSum / Count;
+
+	if (Count < 2)
+	{
+		return Delta;
+	}
+
+	double SquaredSum = 0.0;
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		SquaredSum += FMath::Square((Samples[Index] - Baseline[Index]) - Delta.Mean);
+	}
+
+	const double StandardError = FMath::Sqrt(SquaredSum / (Count - 1)) / FMath::Sqrt(static_cast<double>(Count));
+	Delta.ConfidenceInterval = GetStudentT95(Count - 1) * StandardError;
+
+	return Delta;
+}
+
+/**
+ * @brief Two sided 95% critical value of Student's t distribution
+ * @param DegreesOfFreedom Sample count minus one
+ */
+double FCVarExperiment::GetStudentT95(const int32 DegreesOfFreedom)
+{
+	static const double Table[] =
+	{
+		12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+		2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+		2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+	};
+
+	if (DegreesOfFreedom < 1)
+	{
+		return 0.0;
+	}
+
+	return DegreesOfFreedom <= static_cast<int32>(UE_ARRAY_COUNT(Table)) ? Table[DegreesOfFreedom - 1] : 1.960;
+}
+#pragma endregion
+
+#pragma region Report
+/**
+ * @brief Writes paired deltas of each set against the baseline and the raw window samples as csv
+ */
+void FCVarExperiment::WriteReport() const
+{
+	FString Report = TEXT("Camera,Set,Metric,BaselineMs,DeltaMs,DeltaPct,CI95Ms,Rounds,Significant\n");
+	FString Samples = TEXT("Camera,Round,Order,Set,FrameMs,GameThreadMs,RenderThreadMs,GPUMs\n");
+
+	for (int32 Camera = 0; Camera < Cameras.Num(); ++Camera)
+	{
+		const FString& CameraName = Cameras[Camera]->CameraName;
+		const TArray<TArray<FFrameStats>>& CameraResults = Results[Camera];
+
+		for (int32 Set = 0; Set < CVarSets.Num(); ++Set)
+		{
+			for (int32 Round = 0; Round < CameraResults[Set].Num(); ++Round)
+			{
+				const FFrameStats& Stats = CameraResults[Set][Round];
+				const int32 Order = Round % 2 == 0 ? Set : CVarSets.Num() - 1 - Set;
+				Samples += FString::Printf(TEXT("%s,%d,%d,%s,%.3f,%.3f,%.3f,%.3f\n"), *CameraName, Round, Order, *CVarSets[Set].Name,
+					Stats.AvgFrameMs, Stats.AvgGameThreadMs, Stats.AvgRenderThreadMs, Stats.AvgGPUMs);
+			}
+		}
+
+		for (int32 Set = 1; Set < CVarSets.Num(); ++Set)
+		{
+			for (int32 Metric = 0; Metric < static_cast<int32>(UE_ARRAY_COUNT(CVarExperiment::MetricNames)); ++Metric)
+			{
+				TArray<float> BaselineValues;
+				TArray<float> Values;
+				for (const FFrameStats& Stats : CameraResults[0])
+				{
+					BaselineValues.Add(CVarExperiment::GetMetric(Stats, Metric));
+				}
+				for (const FFrameStats& Stats : CameraResults[Set])
+				{
+					Values.Add(CVarExperiment::GetMetric(Stats, Metric));
+				}
+
+				const FPairedDelta Delta = ComputePairedDelta(BaselineValues, Values);
+				const double DeltaPct = Delta.BaselineMean > 0.0 ? 100.0 * Delta.Mean / Delta.BaselineMean : 0.0;
+				const bool bIsSignificant = FMath::Abs(Delta.Mean) > Delta.ConfidenceInterval;
+
+				Report += FString::Printf(TEXT("%s,%s,%s,%.4f,%.4f,%.2f,%.4f,%d,%s\n"), *CameraName, *CVarSets[Set].Name,
+					CVarExperiment::MetricNames[Metric], Delta.BaselineMean, Delta.Mean, DeltaPct, Delta.ConfidenceInterval,
+					Values.Num(), bIsSignificant ? TEXT("true") : TEXT("false"));
+
+				if (Metric == 0)
+				{
+					UE_LOG(LogTemp, Display, TEXT("%s %s vs %s: %+.3f ms (%+.2f%%) +/- %.3f ms"), *CameraName, *CVarSets[Set].Name,
+						*CVarSets[0].Name, Delta.Mean, DeltaPct, Delta.ConfidenceInterval);
+				}
+			}
+		}
+	}
+
+	const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y.%m.%d_%H.%M"));
+	FUtilities::SaveReport(FString::Printf(TEXT("Experiment_%s.csv"), *Timestamp), Report);
+	FUtilities::SaveReport(FString::Printf(TEXT("Experiment_%s_Samples.csv"), *Timestamp), Samples);
+}
+#pragma endregion
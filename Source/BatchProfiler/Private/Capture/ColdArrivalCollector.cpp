@@ -0,0 +1,224 @@
+#include "Capture/ColdArrivalCollector.h"
+#include "Utilities/ProfilerStats.h"
+#include "BatchProfilerSettings.h"
+#include "ContentStreaming.h"
+#include "UObject/UObjectGlobals.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#endif
+
+#if PLATFORM_LINUX
+#include <stdio.h>
+#endif
+
+namespace ColdArrivalCollector
+{
+	// The new view must be through a few streaming updates in a row without pending requests before streaming counts as complete
+	static constexpr int32 RequiredCompleteTicks = 3;
+}
+
+FColdArrivalCollector::~FColdArrivalCollector()
+{
+	StopArrival();
+}
+
+#pragma region Arrival Window
+/**
+ * @brief Flushes loading and streaming to a quiet state, then starts measuring the hop to the camera
+ * @param Camera Camera the view is moved to
+ */
+void FColdArrivalCollector::BeginArrival(const AProfilingCamera* Camera)
+{
+	BATCHPROFILER_SCOPE(ColdArrivalBegin);
+	StopArrival();
+	bHasResult = false;
+
+	if (!GetDefault<UBatchProfilerSettings>()->MeasureColdArrival)
+	{
+		return;
+	}
+
+	if (!GetProcessIOCounters(StartCounters))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Cold arrival I/O counters are not supported on this platform"));
+		return;
+	}
+
+	// Finish pending loads and streaming of the previous view and purge what it no longer references
+	FlushAsyncLoading();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+	IStreamingManager::Get().BlockTillAllRequestsFinished();
+
+	// I/O is counted from here, time and frames from the end of this frame, which also contains the flush above
+	GetProcessIOCounters(StartCounters);
+	LoadedPackages.Reset();
+	WorstFrameMs = 0.f;
+	ArrivalTicks = 0;
+	CompleteTicks = 0;
+	ArrivalStartTime = FPlatformTime::Seconds();
+	bIsArriving = true;
+
+	AssetLoadedHandle = FCoreUObjectDelegates::OnAssetLoaded.AddRaw(this, &FColdArrivalCollector::OnAssetLoaded);
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FColdArrivalCollector::Tick));
+}
+
+/**
+ * @brief Arrival keeps being measured into the capture window when streaming has not completed yet
+ */
+void FColdArrivalCollector::BeginCapture(const AProfilingCamera* Camera)
+{
+}
+
+/**
+ * @brief Adds the arrival cost of the camera to its summary
+ * @param Summary Summary of the camera
+ */
+void FColdArrivalCollector::EndCapture(FCameraCaptureSummary& Summary)
+{
+	if (bIsArriving)
+	{
+		// Streaming did not complete before the capture window ended
+		CompleteArrival();
+		StreamingSecs = -1.0;
+	}
+
+	if (!bHasResult)
+	{
+		return;
+	}
+
+	Summary.AddMetric(TEXT("ArrivalReadMB"), ArrivalCounters.ReadBytes / (1024.0 * 1024.0));
+	Summary.AddMetric(TEXT("ArrivalReadRequests"), ArrivalCounters.ReadRequests);
+	Summary.AddMetric(TEXT("ArrivalPackages"), ArrivalPackages);
+	Summary.AddMetric(TEXT("ArrivalStreamingSecs"), StreamingSecs);
+	Summary.AddMetric(TEXT("ArrivalWorstFrameMs"), ArrivalWorstFrameMs);
+	bHasResult = false;
+}
+
+bool FColdArrivalCollector::Tick(const float DeltaTime)
+{
+	BATCHPROFILER_SCOPE(ColdArrivalTick);
+	const double Now = FPlatformTime::Seconds();
+
+	// The first frame holds the flush of the previous view and the camera switch, not the cost of the new view
+	if (ArrivalTicks++ == 0)
+	{
+		ArrivalStartTime = Now;
+		return true;
+	}
+
+	WorstFrameMs = FMath::Max(WorstFrameMs, DeltaTime * 1000.f);
+
+	if (!IsStreamingComplete())
+	{
+		CompleteTicks = 0;
+		return true;
+	}
+
+	// Streaming completed when the quiet streak started
+	if (CompleteTicks++ == 0)
+	{
+		StreamingCompleteTime = Now;
+	}
+
+	if (CompleteTicks >= ColdArrivalCollector::RequiredCompleteTicks)
+	{
+		CompleteArrival();
+	}
+
+	return bIsArriving;
+}
+
+void FColdArrivalCollector::OnAssetLoaded(UObject* Asset)
+{
+	if (Asset)
+	{
+		LoadedPackages.Add(Asset->GetOutermost()->GetFName());
+	}
+}
+
+void FColdArrivalCollector::CompleteArrival()
+{
+	FIOCounters EndCounters;
+	GetProcessIOCounters(EndCounters);
+
+	ArrivalCounters.ReadBytes = EndCounters.ReadBytes - StartCounters.ReadBytes;
+	ArrivalCounters.ReadRequests = EndCounters.ReadRequests - StartCounters.ReadRequests;
+	ArrivalPackages = LoadedPackages.Num();
+	StreamingSecs = (CompleteTicks > 0 ? StreamingCompleteTime : FPlatformTime::Seconds()) - ArrivalStartTime;
+	ArrivalWorstFrameMs = WorstFrameMs;
+	bHasResult = true;
+
+	StopArrival();
+}
+
+void FColdArrivalCollector::StopArrival()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	FCoreUObjectDelegates::OnAssetLoaded.Remove(AssetLoadedHandle);
+	AssetLoadedHandle.Reset();
+	bIsArriving = false;
+}
+#pragma endregion
+
+#pragma region Platform Counters
+/**
+ * @brief Reads the bytes read and read requests of the process since it started
+ * @param OutCounters Process I/O counters
+ * @return If the counters could be read
+ */
+bool FColdArrivalCollector::GetProcessIOCounters(FIOCounters& OutCounters)
+{
+#if PLATFORM_WINDOWS
+	IO_COUNTERS IOCounters;
+	if (!::GetProcessIoCounters(::GetCurrentProcess(), &IOCounters))
+	{
+		return false;
+	}
+
+	OutCounters.ReadBytes = IOCounters.ReadTransferCount;
+	OutCounters.ReadRequests = IOCounters.ReadOperationCount;
+	return true;
+#elif PLATFORM_LINUX
+	// rchar and syscr include reads served from the page cache, so warm and cold runs are comparable
+	FILE* File = fopen("/proc/self/io", "r");
+	if (File == nullptr)
+	{
+		return false;
+	}
+
+	char Key[32];
+	unsigned long long Value;
+	int32 Found = 0;
+	while (fscanf(File, "%31s %llu", Key, &Value) == 2)
+	{
+		if (FCStringAnsi::Strcmp(Key, "rchar:") == 0)
+		{
+			OutCounters.ReadBytes = Value;
+			Found++;
+		}
+		else if (FCStringAnsi::Strcmp(Key, "syscr:") == 0)
+		{
+			OutCounters.ReadRequests = Value;
+			Found++;
+		}
+	}
+	fclose(File);
+
+	return Found == 2;
+#else
+	return false;
+#endif
+}
+
+bool FColdArrivalCollector::IsStreamingComplete()
+{
+	return !IsAsyncLoading() && IStreamingManager::Get().GetNumWantingResources() == 0;
+}
+#pragma endregion
@@ -0,0 +1,90 @@
+#include "Capture/FrameStatsRecorder.h"
+#include "Utilities/ProfilerStats.h"
+#include "CoreGlobals.h"
+#include "RHI.h"
+
+FFrameStatsRecorder::~FFrameStatsRecorder()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	}
+}
+
+/**
+ * @brief Clears previous samples and starts sampling every frame
+ */
+void FFrameStatsRecorder::Start()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	}
+
+	FrameTimes.Reset();
+	GameThreadMsSum = 0.0;
+	RenderThreadMsSum = 0.0;
+	GPUMsSum = 0.0;
+	StartTime = FPlatformTime::Seconds();
+
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FFrameStatsRecorder::Tick));
+}
+
+/**
+ * @brief Stops sampling and aggregates the recorded frames
+ * @return Frame statistics of the recorded window
+ */
+FFrameStats FFrameStatsRecorder::Stop()
+{
+	BATCHPROFILER_SCOPE(FrameStatsStop);
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	FFrameStats Stats;
+	Stats.FrameCount = FrameTimes.Num();
+	Stats.DurationSecs = FPlatformTime::Seconds() - StartTime;
+
+	if (Stats.FrameCount == 0)
+	{
+		return Stats;
+	}
+
+	double FrameMsSum = 0.0;
+	for (const float FrameMs : FrameTimes)
+	{
+		FrameMsSum += FrameMs;
+		Stats.MaxFrameMs = FMath::Max(Stats.MaxFrameMs, FrameMs);
+	}
+
+	TArray<float> SortedFrameTimes = FrameTimes;
+	SortedFrameTimes.Sort();
+	const int32 P95Index = FMath::Clamp(FMath::CeilToInt(0.95f * Stats.FrameCount) - 1, 0, Stats.FrameCount - 1);
+
+	Stats.AvgFrameMs = FrameMsSum / Stats.FrameCount;
+
+	double SquaredDeviationSum = 0.0;
+	for (const float FrameMs : FrameTimes)
+	{
+		SquaredDeviationSum += FMath::Square(FrameMs - Stats.AvgFrameMs);
+	}
+	Stats.StdDevFrameMs = FMath::Sqrt(SquaredDeviationSum / Stats.FrameCount);
+	Stats.P95FrameMs = SortedFrameTimes[P95Index];
+	Stats.AvgGameThreadMs = GameThreadMsSum / Stats.FrameCount;
+	Stats.AvgRenderThreadMs = RenderThreadMsSum / Stats.FrameCount;
+	Stats.AvgGPUMs = GPUMsSum / Stats.FrameCount;
+
+	return Stats;
+}
+
+bool FFrameStatsRecorder::Tick(const float DeltaTime)
+{
+	BATCHPROFILER_SCOPE(FrameStatsTick);
+	FrameTimes.Add(DeltaTime * 1000.f);
+	GameThreadMsSum += FPlatformTime::ToMilliseconds(GGameThreadTime);
+	RenderThreadMsSum += FPlatformTime::ToMilliseconds(GRenderThreadTime);
+	GPUMsSum += FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles());
+	return true;
+}
@@ -0,0 +1,262 @@
+#include "Capture/GarbageCollectionCollector.h"
+#include "Utilities/ProfilerStats.h"
+#include "BatchProfilerSettings.h"
+#include "Engine/Engine.h"
+#include "UObject/UObjectGlobals.h"
+#include "Utilities/Utilities.h"
+
+FGarbageCollectionCollector::~FGarbageCollectionCollector()
+{
+	StopTracking();
+}
+
+void FGarbageCollectionCollector::BeginBatch()
+{
+	CameraTopClasses.Reset();
+}
+
+#pragma region Capture Window
+/**
+ * @brief Requests a full purge for the settle delay and starts mirroring object classes
+ * @param Camera Camera the view is moved to
+ */
+void FGarbageCollectionCollector::BeginArrival(const AProfilingCamera* Camera)
+{
+	BATCHPROFILER_SCOPE(GarbageCollectionBeginArrival);
+	const UBatchProfilerSettings* BatchProfilerSettings = GetDefault<UBatchProfilerSettings>();
+	if (BatchProfilerSettings->ForceGarbageCollectionBeforeCapture && GEngine)
+	{
+		// Collected on the next engine tick, which also restarts the periodic collection interval
+		GEngine->ForceGarbageCollection(true);
+	}
+
+	if (BatchProfilerSettings->MeasureGarbageCollection)
+	{
+		StartTracking();
+	}
+}
+
+/**
+ * @brief Starts counting collections and object churn
+ * @param Camera Camera being captured
+ */
+void FGarbageCollectionCollector::BeginCapture(const AProfilingCamera* Camera)
+{
+	BATCHPROFILER_SCOPE(GarbageCollectionBeginCapture);
+	if (!GetDefault<UBatchProfilerSettings>()->MeasureGarbageCollection)
+	{
+		StopTracking();
+		return;
+	}
+
+	// Captures without an arrival start mirroring here
+	StartTracking();
+
+	FScopeLock Lock(&TrackingLock);
+	ClassChurn.Reset();
+	ObjectsCreated = 0;
+	ObjectsDestroyed = 0;
+	CollectCount = 0;
+	CollectTotalSecs = 0.0;
+	CollectMaxSecs = 0.0;
+	CollectStartTime = 0.0;
+	StartTime = FPlatformTime::Seconds();
+	bIsCollecting = true;
+}
+
+/**
+ * @brief Adds collection and churn metrics to the summary and keeps the top classes for the report
+ * @param Summary Summary of the camera
+ */
+void FGarbageCollectionCollector::EndCapture(FCameraCaptureSummary& Summary)
+{
+	BATCHPROFILER_SCOPE(GarbageCollectionEndCapture);
+	if (!bIsCollecting)
+	{
+		return;
+	}
+
+	TArray<FClassChurn> TopClasses;
+	int64 Created;
+	int64 Destroyed;
+	{
+		FScopeLock Lock(&TrackingLock);
+		bIsCollecting = false;
+		Created = ObjectsCreated;
+		Destroyed = ObjectsDestroyed;
+		ClassChurn.GenerateValueArray(TopClasses);
+		ClassChurn.Reset();
+	}
+	StopTracking();
+
+	const double DurationSecs = FMath::Max(FPlatformTime::Seconds() - StartTime, UE_SMALL_NUMBER);
+	Summary.AddMetric(TEXT("GCCount"), CollectCount);
+	Summary.AddMetric(TEXT("GCTotalMs"), CollectTotalSecs * 1000.0);
+	Summary.AddMetric(TEXT("GCMaxMs"), CollectMaxSecs * 1000.0);
+	Summary.AddMetric(TEXT("ObjectsCreatedPerSec"), Created / DurationSecs);
+	Summary.AddMetric(TEXT("ObjectsDestroyedPerSec"), Destroyed / DurationSecs);
+	Summary.AddMetric(TEXT("ObjectsNetDelta"), Created - Destroyed);
+
+	TopClasses.Sort([](const FClassChurn& A, const FClassChurn& B)
+	{
+		return A.Created + A.Destroyed > B.Created + B.Destroyed;
+	});
+	TopClasses.SetNum(FMath::Min(TopClasses.Num(), FMath::Max(GetDefault<UBatchProfilerSettings>()->ChurnTopClassCount, 1)));
+
+	if (TopClasses.Num() > 0)
+	{
+		UE_LOG(LogTemp, Display, TEXT("%s: %d collections (%.2f ms), most churn in %s (%lld created, %lld destroyed)"),
+			*Summary.CameraName, CollectCount, CollectTotalSecs * 1000.0, *TopClasses[0].ClassName.ToString(), TopClasses[0].Created, TopClasses[0].Destroyed);
+	}
+
+	CameraTopClasses.Add(Summary.CameraName, MoveTemp(TopClasses));
+}
+#pragma endregion
+
+#pragma region Object Tracking
+void FGarbageCollectionCollector::StartTracking()
+{
+	if (bIsTracking)
+	{
+		return;
+	}
+
+	GUObjectArray.AddUObjectCreateListener(this);
+	GUObjectArray.AddUObjectDeleteListener(this);
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddRaw(this, &FGarbageCollectionCollector::OnPreGarbageCollect);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FGarbageCollectionCollector::OnPostGarbageCollect);
+
+	// Mirror the class of every live object so destroyed objects can be attributed
+	FScopeLock Lock(&TrackingLock);
+	const int32 NumObjects = GUObjectArray.GetObjectArrayNum();
+	ObjectClassNames.Reset();
+	ObjectClassNames.SetNum(NumObjects);
+	for (int32 Index = 0; Index < NumObjects; ++Index)
+	{
+		const FUObjectItem* ObjectItem = GUObjectArray.IndexToObject(Index);
+		if (ObjectItem && ObjectItem->Object && ObjectItem->Object->GetClass())
+		{
+			ObjectClassNames[Index] = ObjectItem->Object->GetClass()->GetFName();
+		}
+	}
+
+	bIsTracking = true;
+}
+
+void FGarbageCollectionCollector::StopTracking()
+{
+	if (!bIsTracking)
+	{
+		return;
+	}
+
+	GUObjectArray.RemoveUObjectCreateListener(this);
+	GUObjectArray.RemoveUObjectDeleteListener(this);
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	PreGarbageCollectHandle.Reset();
+	PostGarbageCollectHandle.Reset();
+
+	FScopeLock Lock(&TrackingLock);
+	ObjectClassNames.Empty();
+	bIsTracking = false;
+	bIsCollecting = false;
+}
+
+void FGarbageCollectionCollector::NotifyUObjectCreated(const UObjectBase* Object, int32 Index)
+{
+	// The class is assigned before the object is added to the array
+	const FName ClassName = Object->GetClass() ? Object->GetClass()->GetFName() : NAME_None;
+
+	FScopeLock Lock(&TrackingLock);
+	if (Index >= ObjectClassNames.Num())
+	{
+		ObjectClassNames.SetNum(Index + 1);
+	}
+	ObjectClassNames[Index] = ClassName;
+
+	if (bIsCollecting)
+	{
+		FClassChurn& Churn = ClassChurn.FindOrAdd(ClassName);
+		Churn.ClassName = ClassName;
+		Churn.Created++;
+		ObjectsCreated++;
+	}
+}
+
+void FGarbageCollectionCollector::NotifyUObjectDeleted(const UObjectBase* Object, int32 Index)
+{
+	FScopeLock Lock(&TrackingLock);
+	if (!bIsCollecting)
+	{
+		return;
+	}
+
+	const FName ClassName = ObjectClassNames.IsValidIndex(Index) ? ObjectClassNames[Index] : NAME_None;
+	FClassChurn& Churn = ClassChurn.FindOrAdd(ClassName);
+	Churn.ClassName = ClassName;
+	Churn.Destroyed++;
+	ObjectsDestroyed++;
+}
+
+void FGarbageCollectionCollector::OnUObjectArrayShutdown()
+{
+	StopTracking();
+}
+
+void FGarbageCollectionCollector::OnPreGarbageCollect()
+{
+	CollectStartTime = FPlatformTime::Seconds();
+}
+
+/**
+ * @brief Counts a collection of the capture window, purging may continue incrementally over the next frames
+ */
+void FGarbageCollectionCollector::OnPostGarbageCollect()
+{
+	if (!bIsCollecting || CollectStartTime == 0.0)
+	{
+		return;
+	}
+
+	const double CollectSecs = FPlatformTime::Seconds() - CollectStartTime;
+	CollectCount++;
+	CollectTotalSecs += CollectSecs;
+	CollectMaxSecs = FMath::Max(CollectMaxSecs, CollectSecs);
+	CollectStartTime = 0.0;
+}
+#pragma endregion
+
+#pragma region Report
+/**
+ * @brief Writes the classes with the most churn of each camera
+ * @param Summaries Summaries of every captured camera
+ */
+void FGarbageCollectionCollector::CompleteBatch(const TArray<FCameraCaptureSummary>& Summaries)
+{
+	if (CameraTopClasses.Num() == 0)
+	{
+		return;
+	}
+
+	FString Report = TEXT("Camera,Rank,Class,Created,Destroyed,Churn\n");
+	for (const FCameraCaptureSummary& Summary : Summaries)
+	{
+		const TArray<FClassChurn>* TopClasses = CameraTopClasses.Find(Summary.CameraName);
+		if (TopClasses == nullptr)
+		{
+			continue;
+		}
+
+		for (int32 Rank = 0; Rank < TopClasses->Num(); ++Rank)
+		{
+			const FClassChurn& Churn = (*TopClasses)[Rank];
+			Report += FString::Printf(TEXT("%s,%d,%s,%lld,%lld,%lld\n"),
+				*Summary.CameraName, Rank + 1, *Churn.ClassName.ToString(), Churn.Created, Churn.Destroyed, Churn.Created + Churn.Destroyed);
+		}
+	}
+
+	const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y.%m.%d_%H.%M"));
+	FUtilities::SaveReport(FString::Printf(TEXT("ObjectChurn_%s.csv"), *Timestamp), Report);
+}
+#pragma endregion
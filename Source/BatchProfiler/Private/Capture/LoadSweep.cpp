@@ -0,0 +1,411 @@
+#include "Capture/LoadSweep.h"
+#include "Utilities/ProfilerStats.h"
+#include "BatchProfilerSettings.h"
+#include "ProfilingCamera.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "Utilities/Utilities.h"
+
+namespace LoadSweep
+{
+	static const TCHAR* MetricNames[] = { TEXT("FrameMs"), TEXT("GameThreadMs"), TEXT("RenderThreadMs"), TEXT("GPUMs") };
+
+	static double GetMetric(const FFrameStats& Stats, const int32 MetricIndex)
+	{
+		switch (MetricIndex)
+		{
+		case 0:		return Stats.AvgFrameMs;
+		case 1:		return Stats.AvgGameThreadMs;
+		case 2:		return Stats.AvgRenderThreadMs;
+		default:	return Stats.AvgGPUMs;
+		}
+	}
+
+	// Growth exponents above this are reported as super-linear, leaves room for measurement noise around 1
+	static constexpr double SuperLinearExponent = 1.2;
+
+	// Range and resolution of the exponent search of the power fit
+	static constexpr double MinExponent = 0.1;
+	static constexpr double MaxExponent = 4.0;
+	static constexpr double ExponentStep = 0.01;
+
+	/**
+	 * @brief Least squares fit of cost = Base + Scale * (count / MaxCount)^Exponent for a fixed exponent
+	 * @return Sum of squared residuals
+	 */
+	static double FitPowerTerm(const TArray<int32>& Counts, const TArray<double>& CostMs, const int32 PointCount, const double MaxCount,
+		const double Exponent, double& OutBase, double& OutScale)
+	{
+		// Counts are normalized so large populations raised to high exponents stay well conditioned
+		double MeanX = 0.0;
+		double MeanY = 0.0;
+		for (int32 Index = 0; Index < PointCount; ++Index)
+		{
+			MeanX += FMath::Pow(Counts[Index] / MaxCount, Exponent);
+			MeanY += CostMs[Index];
+		}
+		MeanX /= PointCount;
+		MeanY /= PointCount;
+
+		double CovarianceXY = 0.0;
+		double VarianceX = 0.0;
+		for (int32 Index = 0; Index < PointCount; ++Index)
+		{
+			const double X = FMath::Pow(Counts[Index] / MaxCount, Exponent);
+			CovarianceXY += (X - MeanX) * (CostMs[Index] - MeanY);
+			VarianceX += FMath::Square(X - MeanX);
+		}
+
+		OutScale = VarianceX > 0.0 ? CovarianceXY / VarianceX : 0.0;
+		OutBase = MeanY - OutScale * MeanX;
+
+		double SquaredError = 0.0;
+		for (int32 Index = 0; Index < PointCount; ++Index)
+		{
+			SquaredError += FMath::Square(CostMs[Index] - OutBase - OutScale * FMath::Pow(Counts[Index] / MaxCount, Exponent));
+		}
+
+		return SquaredError;
+	}
+
+	static constexpr float GroundTraceDistance = 100000.f;
+
+	// Every camera spawns the same layout
+	static constexpr int32 SpawnSeed = 1337;
+}
+
+FLoadSweep::FLoadSweep(const TArray<AProfilingCamera*>& InCameras, UClass* InActorClass, const TArray<int32>& InCounts)
+	: Cameras(InCameras), ActorClass(InActorClass), Counts(InCounts)
+{
+	Counts.Sort();
+
+	Results.SetNum(Cameras.Num());
+	for (TArray<FFrameStats>& CameraResults : Results)
+	{
+		CameraResults.SetNum(Counts.Num());
+	}
+}
+
+FLoadSweep::~FLoadSweep()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		DestroyPopulation();
+	}
+}
+
+/**
+ * @brief Starts the sweep from the first camera
+ * @param InOnComplete Called after the report is written
+ */
+void FLoadSweep::Start(const FSimpleDelegate& InOnComplete)
+{
+	OnComplete = InOnComplete;
+	CameraIndex = 0;
+
+	StartCamera();
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FLoadSweep::Tick));
+}
+
+bool FLoadSweep::Tick(float DeltaTime)
+{
+	BATCHPROFILER_SCOPE(LoadSweepTick);
+	const double Now = FPlatformTime::Seconds();
+	if (Now < PhaseEndTime)
+	{
+		return true;
+	}
+
+	switch (Phase)
+	{
+	case EPhase::Arrive:
+		StartStep();
+		break;
+
+	case EPhase::Settle:
+		Recorder.Start();
+		Phase = EPhase::Measure;
+		PhaseEndTime = Now + GetDefault<UBatchProfilerSettings>()->SweepWindowSeconds;
+		break;
+
+	case EPhase::Measure:
+		FinishStep();
+		break;
+	}
+
+	if (CameraIndex >= Cameras.Num())
+	{
+		TickerHandle.Reset();
+		WriteReport();
+		OnComplete.ExecuteIfBound();
+		return false;
+	}
+
+	return true;
+}
+
+#pragma region Steps
+/**
+ * @brief Moves the view to the current camera and waits for the capture delay
+ */
+void FLoadSweep::StartCamera()
+{
+	AProfilingCamera* Camera = Cameras[CameraIndex];
+	UE_LOG(LogTemp, Warning, TEXT("Sweeping From: %s"), *Camera->CameraName);
+	Camera->ActivateCamera();
+
+	SpawnStream.Initialize(LoadSweep::SpawnSeed);
+	StepIndex = 0;
+	Phase = EPhase::Arrive;
+	PhaseEndTime = FPlatformTime::Seconds() + GetDefault<UBatchProfilerSettings>()->DelayBeforeEachCapture;
+}
+
+/**
+ * @brief Grows the population to the current step and waits for it to settle
+ */
+void FLoadSweep::StartStep()
+{
+	SetPopulation(Counts[StepIndex]);
+	Phase = EPhase::Settle;
+	PhaseEndTime = FPlatformTime::Seconds() + GetDefault<UBatchProfilerSettings>()->SweepSettleSeconds;
+}
+
+/**
+ * @brief Stores the step result and advances step and camera
+ */
+void FLoadSweep::FinishStep()
+{
+	Results[CameraIndex][StepIndex] = Recorder.Stop();
+	UE_LOG(LogTemp, Display, TEXT("%s with %d actors: %.3f ms"), *Cameras[CameraIndex]->CameraName, Counts[StepIndex], Results[CameraIndex][StepIndex].AvgFrameMs);
+
+	if (++StepIndex < Counts.Num())
+	{
+		StartStep();
+		return;
+	}
+
+	DestroyPopulation();
+	if (++CameraIndex < Cameras.Num())
+	{
+		StartCamera();
+	}
+}
+
+/**
+ * @brief Spawns actors in front of the camera until the population matches the count
+ * @param Count Population of the step
+ */
+void FLoadSweep::SetPopulation(const int32 Count)
+{
+	SpawnedActors.RemoveAll([](const TWeakObjectPtr<AActor>& Actor)
+	{
+		return !Actor.IsValid();
+	});
+
+	const AProfilingCamera* Camera = Cameras[CameraIndex];
+	UWorld* World = Camera->GetWorld();
+	if (!ActorClass.IsValid() || World == nullptr)
+	{
+		return;
+	}
+
+	// Actors are scattered on a disc in front of the camera so the population stays in view
+	const UBatchProfilerSettings* BatchProfilerSettings = GetDefault<UBatchProfilerSettings>();
+	const FVector Forward = Camera->GetActorForwardVector().GetSafeNormal2D();
+	const FVector Center = Camera->GetActorLocation() + Forward * BatchProfilerSettings->SweepSpawnDistance;
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+
+	while (SpawnedActors.Num() < Count)
+	{
+		const float Angle = SpawnStream.FRandRange(0.f, UE_TWO_PI);
+		const float Radius = BatchProfilerSettings->SweepSpawnRadius * FMath::Sqrt(SpawnStream.FRand());
+		FVector Location = Center + FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 0.f);
+		const FRotator Rotation(0.f, SpawnStream.FRandRange(0.f, 360.f), 0.f);
+
+		// Place on the ground below the point when there is one
+		FHitResult Hit;
+		if (World->LineTraceSingleByChannel(Hit, Location, Location - FVector(0.f, 0.f, LoadSweep::GroundTraceDistance), ECC_Visibility))
+		{
+			Location = Hit.ImpactPoint;
+		}
+
+		AActor* Actor = World->SpawnActor<AActor>(ActorClass.Get(), Location, Rotation, SpawnParameters);
+		if (Actor == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Could not spawn %s, sweep step has %d actors"), *ActorClass->GetName(), SpawnedActors.Num());
+			break;
+		}
+
+		// Agents need their controller to cost what they cost in game
+		if (APawn* Pawn = Cast<APawn>(Actor))
+		{
+			if (Pawn->GetController() == nullptr)
+			{
+				Pawn->SpawnDefaultController();
+			}
+		}
+
+		SpawnedActors.Add(Actor);
+	}
+
+	while (SpawnedActors.Num() > Count)
+	{
+		if (AActor* Actor = SpawnedActors.Pop().Get())
+		{
+			Actor->Destroy();
+		}
+	}
+}
+
+void FLoadSweep::DestroyPopulation()
+{
+	for (const TWeakObjectPtr<AActor>& Actor : SpawnedActors)
+	{
+		if (APawn* Pawn = Cast<APawn>(Actor.Get()))
+		{
+			if (AController* Controller = Pawn->GetController())
+			{
+				Controller->Destroy();
+			}
+		}
+
+		if (Actor.IsValid())
+		{
+			Actor->Destroy();
+		}
+	}
+
+	SpawnedActors.Reset();
+}
+#pragma endregion
+
+#pragma region Statistics
+/**
+ * @brief Fits a line to cost versus count and the growth exponent of cost = base + scale * count^k over every step
+ * @param InCounts Population of each step, ascending
+ * @param CostMs Cost of each step
+ * @return Fit of the curve
+ */
+FLoadSweep::FCostFit FLoadSweep::FitCost(const TArray<int32>& InCounts, const TArray<double>& CostMs)
+{
+	FCostFit Fit;
+	const int32 Count = FMath::Min(InCounts.Num(), CostMs.Num());
+	if (Count == 0)
+	{
+		return Fit;
+	}
+
+	// Least squares line, the slope is the marginal cost of one actor
+	double MeanX = 0.0;
+	double MeanY = 0.0;
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		MeanX += InCounts[Index];
+		MeanY += CostMs[Index];
+	}
+	MeanX /= Count;
+	MeanY /= Count;
+
+	double CovarianceXY = 0.0;
+	double VarianceX = 0.0;
+	double VarianceY = 0.0;
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		CovarianceXY += (InCounts[Index] - MeanX) * (CostMs[Index] - MeanY);
+		VarianceX += FMath::Square(InCounts[Index] - MeanX);
+		VarianceY += FMath::Square(CostMs[Index] - MeanY);
+	}
+
+	Fit.MsPerActor = VarianceX > 0.0 ? CovarianceXY / VarianceX : 0.0;
+	Fit.BaseMs = MeanY - Fit.MsPerActor * MeanX;
+	Fit.LinearR2 = VarianceX > 0.0 && VarianceY > 0.0 ? FMath::Square(CovarianceXY) / (VarianceX * VarianceY) : 0.0;
+
+	// Every step is fitted, noisy steps below the first one are kept so the exponent is not biased upwards
+	double MaxCount = 0.0;
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		MaxCount = FMath::Max(MaxCount, static_cast<double>(InCounts[Index]));
+	}
+
+	if (Count >= 3 && MaxCount > 0.0)
+	{
+		double BestError = TNumericLimits<double>::Max();
+		double BestScale = 0.0;
+		for (double Exponent = LoadSweep::MinExponent; Exponent <= LoadSweep::MaxExponent; Exponent += LoadSweep::ExponentStep)
+		{
+			double Base = 0.0;
+			double Scale = 0.0;
+			const double SquaredError = LoadSweep::FitPowerTerm(InCounts, CostMs, Count, MaxCount, Exponent, Base, Scale);
+			if (SquaredError < BestError)
+			{
+				BestError = SquaredError;
+				BestScale = Scale;
+				Fit.Exponent = Exponent;
+			}
+		}
+
+		// Cost that does not grow with the population has no growth exponent
+		if (BestScale <= 0.0)
+		{
+			Fit.Exponent = 0.0;
+		}
+
+		Fit.ExponentPoints = Count;
+		Fit.bIsSuperLinear = Fit.Exponent > LoadSweep::SuperLinearExponent;
+	}
+
+	return Fit;
+}
+#pragma endregion
+
+#pragma region Report
+/**
+ * @brief Writes the cost of each step and the fitted curve of each camera as csv
+ */
+void FLoadSweep::WriteReport() const
+{
+	const FString ClassName = ActorClass.IsValid() ? ActorClass->GetName() : TEXT("None");
+	FString Samples = TEXT("Camera,Class,Count,Frames,AvgFrameMs,P95FrameMs,GameThreadMs,RenderThreadMs,GPUMs\n");
+	FString Fits = TEXT("Camera,Class,Metric,BaseMs,MsPerActor,LinearR2,Exponent,ExponentPoints,SuperLinear\n");
+
+	for (int32 Camera = 0; Camera < Cameras.Num(); ++Camera)
+	{
+		const FString& CameraName = Cameras[Camera]->CameraName;
+		const TArray<FFrameStats>& CameraResults = Results[Camera];
+
+		for (int32 Step = 0; Step < Counts.Num(); ++Step)
+		{
+			const FFrameStats& Stats = CameraResults[Step];
+			Samples += FString::Printf(TEXT("%s,%s,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n"), *CameraName, *ClassName, Counts[Step], Stats.FrameCount,
+				Stats.AvgFrameMs, Stats.P95FrameMs, Stats.AvgGameThreadMs, Stats.AvgRenderThreadMs, Stats.AvgGPUMs);
+		}
+
+		for (int32 Metric = 0; Metric < static_cast<int32>(UE_ARRAY_COUNT(LoadSweep::MetricNames)); ++Metric)
+		{
+			TArray<double> CostMs;
+			for (const FFrameStats& Stats : CameraResults)
+			{
+				CostMs.Add(LoadSweep::GetMetric(Stats, Metric));
+			}
+
+			const FCostFit Fit = FitCost(Counts, CostMs);
+			Fits += FString::Printf(TEXT("%s,%s,%s,%.4f,%.5f,%.3f,%.3f,%d,%s\n"), *CameraName, *ClassName, LoadSweep::MetricNames[Metric],
+				Fit.BaseMs, Fit.MsPerActor, Fit.LinearR2, Fit.Exponent, Fit.ExponentPoints, Fit.bIsSuperLinear ? TEXT("true") : TEXT("false"));
+
+			if (Fit.bIsSuperLinear)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("%s %s grows super-linearly with %s count (exponent %.2f)"), *CameraName,
+					LoadSweep::MetricNames[Metric], *ClassName, Fit.Exponent);
+			}
+		}
+	}
+
+	const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y.%m.%d_%H.%M"));
+	FUtilities::SaveReport(FString::Printf(TEXT("LoadSweep_%s.csv"), *Timestamp), Samples);
+	FUtilities::SaveReport(FString::Printf(TEXT("LoadSweep_%s_Fit.csv"), *Timestamp), Fits);
+}
+#pragma endregion
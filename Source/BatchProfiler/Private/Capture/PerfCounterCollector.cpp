@@ -0,0 +1,298 @@
+#include "Capture/PerfCounterCollector.h"
+#include "Utilities/ProfilerStats.h"
+#include "BatchProfilerSettings.h"
+
+#if PLATFORM_LINUX
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace PerfCounterCollector
+{
+#if PLATFORM_LINUX
+	struct FCounterConfig
+	{
+		uint32 Type;
+		uint64 Config;
+	};
+
+	// Event of each counter, in ECounter order
+	static constexpr FCounterConfig CounterConfigs[] =
+	{
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+		{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+		{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+		{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS }
+	};
+
+	// PERF_FORMAT_GROUP layout: counter count, time enabled, time running, then one value per counter in open order
+	static constexpr int32 GroupHeaderCount = 3;
+	static constexpr int32 MaxGroupSize = UE_ARRAY_COUNT(CounterConfigs);
+
+	/**
+	 * @brief Opens a counter of a thread, kernel time is excluded when the kernel does not permit it
+	 * @param GroupLeader Descriptor of the group leader, -1 opens a disabled leader
+	 * @return File descriptor or -1
+	 */
+	static int32 OpenCounter(const uint32 Type, const uint64 Config, const uint32 ThreadId, const int32 GroupLeader)
+	{
+		perf_event_attr Attributes;
+		FMemory::Memzero(Attributes);
+		Attributes.type = Type;
+		Attributes.size = sizeof(Attributes);
+		Attributes.config = Config;
+		Attributes.disabled = GroupLeader < 0 ? 1 : 0;
+		Attributes.exclude_hv = 1;
+		Attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		int32 Descriptor = static_cast<int32>(syscall(__NR_perf_event_open, &Attributes, ThreadId, -1, GroupLeader, 0));
+		if (Descriptor < 0)
+		{
+			Attributes.exclude_kernel = 1;
+			Descriptor = static_cast<int32>(syscall(__NR_perf_event_open, &Attributes, ThreadId, -1, GroupLeader, 0));
+		}
+
+		return Descriptor;
+	}
+#endif
+}
+
+FPerfCounterCollector::~FPerfCounterCollector()
+{
+	CloseCounters();
+}
+
+#pragma region Capture Window
+/**
+ * @brief Opens and starts the counters of the game and render threads
+ * @param Camera Camera being captured
+ */
+void FPerfCounterCollector::BeginCapture(const AProfilingCamera* Camera)
+{
+	BATCHPROFILER_SCOPE(PerfCounterBeginCapture);
+	CloseCounters();
+	if (!GetDefault<UBatchProfilerSettings>()->ReadPerfCounters)
+	{
+		return;
+	}
+
+#if PLATFORM_LINUX
+	// Threads are looked up for every window, the render thread may be recreated between captures
+	OpenThreadCounters(TEXT("GameThread"), GGameThreadId);
+	if (GRenderThreadId != 0 && GRenderThreadId != GGameThreadId)
+	{
+		OpenThreadCounters(TEXT("RenderThread"), GRenderThreadId);
+	}
+
+	// Groups are reset and enabled through their leader so all their counters run over the same intervals
+	for (const FThreadCounters& Counters : ThreadCounters)
+	{
+		for (const FCounterGroup* Group : { &Counters.HardwareGroup, &Counters.SoftwareGroup })
+		{
+			if (Group->Leader >= 0)
+			{
+				ioctl(Group->Leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+				ioctl(Group->Leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+			}
+		}
+	}
+#else
+	if (!bHasLoggedFallback)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Performance counters are only supported on Linux"));
+		bHasLoggedFallback = true;
+	}
+#endif
+}
+
+/**
+ * @brief Stops the counters and adds per frame values to the summary
+ * @param Summary Summary of the camera
+ */
+void FPerfCounterCollector::EndCapture(FCameraCaptureSummary& Summary)
+{
+	BATCHPROFILER_SCOPE(PerfCounterEndCapture);
+#if PLATFORM_LINUX
+	const double FrameCount = FMath::Max(1, Summary.FrameStats.FrameCount);
+
+	for (const FThreadCounters& Counters : ThreadCounters)
+	{
+		double Values[ECounter::Count];
+		for (double& Value : Values)
+		{
+			Value = -1.0;
+		}
+		ReadCounterGroup(Counters.HardwareGroup, Values);
+		ReadCounterGroup(Counters.SoftwareGroup, Values);
+
+		const FString& Prefix = Counters.Prefix;
+		if (Values[Instructions] >= 0.0 && Values[Cycles] > 0.0)
+		{
+			Summary.AddMetric(Prefix + TEXT("MInstructions"), Values[Instructions] / FrameCount / 1e6);
+			Summary.AddMetric(Prefix + TEXT("IPC"), Values[Instructions] / Values[Cycles]);
+		}
+
+		// Misses per thousand instructions separate memory bound from compute bound work
+		if (Values[CacheMisses] >= 0.0)
+		{
+			Summary.AddMetric(Prefix + TEXT("KCacheMisses"), Values[CacheMisses] / FrameCount / 1e3);
+			if (Values[Instructions] > 0.0)
+			{
+				Summary.AddMetric(Prefix + TEXT("CacheMPKI"), Values[CacheMisses] / Values[Instructions] * 1e3);
+			}
+		}
+
+		if (Values[BranchMisses] >= 0.0)
+		{
+			Summary.AddMetric(Prefix + TEXT("KBranchMisses"), Values[BranchMisses] / FrameCount / 1e3);
+		}
+
+		if (Values[ContextSwitches] >= 0.0)
+		{
+			Summary.AddMetric(Prefix + TEXT("ContextSwitches"), Values[ContextSwitches] / FrameCount);
+		}
+
+		if (Values[TaskClock] >= 0.0)
+		{
+			Summary.AddMetric(Prefix + TEXT("TaskClockMs"), Values[TaskClock] / FrameCount / 1e6);
+		}
+
+		if (Values[PageFaults] >= 0.0)
+		{
+			Summary.AddMetric(Prefix + TEXT("PageFaults"), Values[PageFaults] / FrameCount);
+		}
+	}
+#endif
+
+	CloseCounters();
+}
+#pragma endregion
+
+#pragma region Counters
+/**
+ * @brief Opens hardware and software counters of a thread, values are reported per frame
+ * @param Prefix Metric name prefix of the thread
+ * @param ThreadId OS thread id
+ */
+void FPerfCounterCollector::OpenThreadCounters(const FString& Prefix, const uint32 ThreadId)
+{
+#if PLATFORM_LINUX
+	FThreadCounters& Counters = ThreadCounters.AddDefaulted_GetRef();
+	Counters.Prefix = Prefix;
+	Counters.ThreadId = ThreadId;
+	for (int32& Descriptor : Counters.Descriptors)
+	{
+		Descriptor = -1;
+	}
+
+	// Cycles lead the hardware group, instructions and misses are only counted while cycles are
+	OpenCounterGroup(Counters, Counters.HardwareGroup, { Cycles, Instructions, CacheMisses, BranchMisses });
+
+	// Hardware counters are not available in most virtual machines or with a strict perf_event_paranoid
+	const bool bHasHardwareCounters = Counters.Descriptors[Instructions] >= 0 && Counters.Descriptors[Cycles] >= 0;
+	if (bHasHardwareCounters)
+	{
+		OpenCounterGroup(Counters, Counters.SoftwareGroup, { ContextSwitches });
+	}
+	else
+	{
+		OpenCounterGroup(Counters, Counters.SoftwareGroup, { ContextSwitches, TaskClock, PageFaults });
+
+		if (!bHasLoggedFallback)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Hardware performance counters are not permitted, falling back to software counters"));
+			bHasLoggedFallback = true;
+		}
+	}
+#endif
+}
+
+/**
+ * @brief Opens a group of counters, the first counter that opens leads the group and the others are read with it
+ * @param Counters Counters of the thread
+ * @param Group Group to open
+ * @param GroupCounters Counters of the group, the leader first
+ */
+void FPerfCounterCollector::OpenCounterGroup(FThreadCounters& Counters, FCounterGroup& Group, std::initializer_list<ECounter> GroupCounters)
+{
+#if PLATFORM_LINUX
+	for (const ECounter Counter : GroupCounters)
+	{
+		const PerfCounterCollector::FCounterConfig& Config = PerfCounterCollector::CounterConfigs[Counter];
+		const int32 Descriptor = PerfCounterCollector::OpenCounter(Config.Type, Config.Config, Counters.ThreadId, Group.Leader);
+		Counters.Descriptors[Counter] = Descriptor;
+
+		// A counter the kernel does not support is left out, the rest of the group is still read
+		if (Descriptor < 0)
+		{
+			continue;
+		}
+
+		if (Group.Leader < 0)
+		{
+			Group.Leader = Descriptor;
+		}
+		Group.Counters.Add(Counter);
+	}
+#endif
+}
+
+/**
+ * @brief Stops a group and reads its counters, scaled up when the kernel multiplexed the group with other groups
+ * @param Group Group to read
+ * @param OutValues Values indexed by counter, left at -1 if the group is not open or was never scheduled
+ */
+void FPerfCounterCollector::ReadCounterGroup(const FCounterGroup& Group, double* OutValues)
+{
+#if PLATFORM_LINUX
+	if (Group.Leader < 0)
+	{
+		return;
+	}
+
+	ioctl(Group.Leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+	uint64 Buffer[PerfCounterCollector::GroupHeaderCount + PerfCounterCollector::MaxGroupSize];
+	const ssize_t ExpectedSize = (PerfCounterCollector::GroupHeaderCount + Group.Counters.Num()) * sizeof(uint64);
+	if (read(Group.Leader, Buffer, sizeof(Buffer)) != ExpectedSize || Buffer[0] != static_cast<uint64>(Group.Counters.Num()))
+	{
+		return;
+	}
+
+	const uint64 TimeEnabled = Buffer[1];
+	const uint64 TimeRunning = Buffer[2];
+	if (TimeRunning == 0)
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < Group.Counters.Num(); ++Index)
+	{
+		OutValues[Group.Counters[Index]] = static_cast<double>(Buffer[PerfCounterCollector::GroupHeaderCount + Index]) * TimeEnabled / TimeRunning;
+	}
+#endif
+}
+
+void FPerfCounterCollector::CloseCounters()
+{
+#if PLATFORM_LINUX
+	for (const FThreadCounters& Counters : ThreadCounters)
+	{
+		for (const int32 Descriptor : Counters.Descriptors)
+		{
+			if (Descriptor >= 0)
+			{
+				close(Descriptor);
+			}
+		}
+	}
+#endif
+
+	ThreadCounters.Reset();
+}
+#pragma endregion
@@ -0,0 +1,266 @@
+#include "Capture/ReplayProfiler.h"
+#include "Utilities/ProfilerStats.h"
+#include "BatchProfiler.h"
+#include "BatchProfilerSettings.h"
+#include "Engine/DemoNetDriver.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Utilities/TraceChannels.h"
+#include "Utilities/Utilities.h"
+
+namespace ReplayProfiler
+{
+	static constexpr double ReplayLoadTimeoutSecs = 120.0;
+	static constexpr double SeekTimeoutSecs = 60.0;
+}
+
+FReplayProfiler::FReplayProfiler(FBatchProfilerModule& InProfilerModule, const TArray<FString>& InCameraNames)
+	: ProfilerModule(InProfilerModule), CameraNames(InCameraNames)
+{
+}
+
+FReplayProfiler::~FReplayProfiler()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	}
+}
+
+#pragma region Recording
+/**
+ * @brief Starts recording a replay of the running game
+ * @param ReplayName Name of the replay
+ * @return If recording is started
+ */
+bool FReplayProfiler::StartRecording(const FString& ReplayName)
+{
+	const UWorld* World = FUtilities::GetGameWorld();
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	if (GameInstance == nullptr)
+	{
+		return false;
+	}
+
+	GameInstance->StartRecordingReplay(ReplayName, ReplayName);
+	UE_LOG(LogTemp, Display, TEXT("Recording Replay: %s"), *ReplayName);
+	return true;
+}
+
+/**
+ * @brief Stops recording the replay of the running game
+ */
+void FReplayProfiler::StopRecording()
+{
+	const UWorld* World = FUtilities::GetGameWorld();
+	if (UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr)
+	{
+		GameInstance->StopRecordingReplay();
+		UE_LOG(LogTemp, Display, TEXT("Stopped Recording Replay"));
+	}
+}
+#pragma endregion
+
+#pragma region Playback
+/**
+ * @brief Loads the replay and captures the segment from each camera
+ * @param InReplayName Name of the recorded replay
+ * @param InStartSecs Segment start in replay time
+ * @param InDurationSecs Segment duration
+ * @param InOnComplete Called after every camera is captured
+ * @return If the replay is started
+ */
+bool FReplayProfiler::Start(const FString& InReplayName, const float InStartSecs, const float InDurationSecs, const FSimpleDelegate& InOnComplete)
+{
+	const UWorld* World = FUtilities::GetGameWorld();
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	if (GameInstance == nullptr || CameraNames.Num() == 0 || !GameInstance->PlayReplay(InReplayName))
+	{
+		return false;
+	}
+
+	ReplayName = InReplayName;
+	StartSecs = InStartSecs;
+	DurationSecs = InDurationSecs;
+	OnComplete = InOnComplete;
+	CameraIndex = 0;
+
+	// Playing a replay reloads the map, wait until the replay world is playing and cameras are registered again
+	Phase = EPhase::WaitingForReplay;
+	PhaseEndTime = FPlatformTime::Seconds() + ReplayProfiler::ReplayLoadTimeoutSecs;
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FReplayProfiler::Tick));
+
+	return true;
+}
+
+bool FReplayProfiler::Tick(float DeltaTime)
+{
+	BATCHPROFILER_SCOPE(ReplayTick);
+	const double Now = FPlatformTime::Seconds();
+
+	switch (Phase)
+	{
+	case EPhase::WaitingForReplay:
+		if (const UDemoNetDriver* DemoNetDriver = GetDemoNetDriver())
+		{
+			if (DemoNetDriver->IsPlaying() && ProfilerModule.GetBatchCameras().Num() > 0)
+			{
+				const float TotalSecs = DemoNetDriver->GetDemoTotalTime();
+				if (StartSecs + DurationSecs > TotalSecs)
+				{
+					UE_LOG(LogTemp, Warning, TEXT("Replay %s is %.1f seconds, segment is clamped"), *ReplayName, TotalSecs);
+					StartSecs = FMath::Clamp(StartSecs, 0.f, TotalSecs);
+					DurationSecs = TotalSecs - StartSecs;
+				}
+
+				StartCamera();
+				break;
+			}
+		}
+
+		if (Now > PhaseEndTime)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Replay %s did not start playing"), *ReplayName);
+			Finish();
+		}
+		break;
+
+	case EPhase::Arrive:
+		if (Now >= PhaseEndTime)
+		{
+			UDemoNetDriver* DemoNetDriver = GetDemoNetDriver();
+			if (DemoNetDriver == nullptr)
+			{
+				UE_LOG(LogTemp, Error, TEXT("Replay %s stopped playing"), *ReplayName);
+				Finish();
+				break;
+			}
+
+			Phase = EPhase::Seeking;
+			PhaseEndTime = Now + ReplayProfiler::SeekTimeoutSecs;
+			DemoNetDriver->GotoTimeInSeconds(StartSecs, FOnGotoTimeDelegate::CreateRaw(this, &FReplayProfiler::OnGotoTimeComplete, ++SeekId));
+		}
+		break;
+
+	case EPhase::Seeking:
+		if (Now > PhaseEndTime)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Seeking replay timed out for %s, skipping"), *CameraNames[CameraIndex]);
+			CameraIndex++;
+			StartCamera();
+		}
+		break;
+
+	case EPhase::Capturing:
+		if (Now >= PhaseEndTime)
+		{
+			FinishCamera();
+		}
+		break;
+	}
+
+	return TickerHandle.IsValid();
+}
+
+/**
+ * @brief Moves the view to the next registered camera of the replay world
+ */
+void FReplayProfiler::StartCamera()
+{
+	while (CameraNames.IsValidIndex(CameraIndex) && ProfilerModule.FindProfilingCamera(CameraNames[CameraIndex]) == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Camera %s is not registered in replay world, skipping"), *CameraNames[CameraIndex]);
+		CameraIndex++;
+	}
+
+	if (!CameraNames.IsValidIndex(CameraIndex))
+	{
+		Finish();
+		return;
+	}
+
+	AProfilingCamera* Camera = ProfilerModule.FindProfilingCamera(CameraNames[CameraIndex]);
+	UE_LOG(LogTemp, Warning, TEXT("Capturing Replay From: %s"), *Camera->CameraName);
+	ProfilerModule.BeginCameraArrival(Camera);
+	Camera->ActivateCamera();
+
+	Phase = EPhase::Arrive;
+	PhaseEndTime = FPlatformTime::Seconds() + GetDefault<UBatchProfilerSettings>()->DelayBeforeEachCapture;
+}
+
+/**
+ * @brief Starts the capture window once the replay is at the segment start
+ * @param bWasSuccessful If seeking succeeded
+ * @param InSeekId Seek the callback belongs to
+ */
+void FReplayProfiler::OnGotoTimeComplete(const bool bWasSuccessful, const uint32 InSeekId)
+{
+	if (Phase != EPhase::Seeking || InSeekId != SeekId)
+	{
+		return;
+	}
+
+	AProfilingCamera* Camera = ProfilerModule.FindProfilingCamera(CameraNames[CameraIndex]);
+	if (!bWasSuccessful || Camera == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not seek replay for %s, skipping"), *CameraNames[CameraIndex]);
+		CameraIndex++;
+		StartCamera();
+		return;
+	}
+
+	// Seeking may restore the spectator view target from the checkpoint
+	Camera->ActivateCamera();
+
+	const UBatchProfilerSettings* BatchProfilerSettings = GetDefault<UBatchProfilerSettings>();
+	if (BatchProfilerSettings->TraceReplayCaptures)
+	{
+		const FString EnabledTraceChannels = FTraceChannels::BuildChannelSet(BatchProfilerSettings->TraceSettings.EnabledTraceChannels);
+		FUtilities::ExecuteCommand(FString::Printf(TEXT("trace.file %s_Replay %s"), *Camera->GetFilename(), *EnabledTraceChannels));
+	}
+
+	ProfilerModule.BeginCaptureWindow(Camera);
+	Phase = EPhase::Capturing;
+	PhaseEndTime = FPlatformTime::Seconds() + DurationSecs;
+}
+
+void FReplayProfiler::FinishCamera()
+{
+	if (const AProfilingCamera* Camera = ProfilerModule.FindProfilingCamera(CameraNames[CameraIndex]))
+	{
+		ProfilerModule.EndCaptureWindow(Camera);
+	}
+	else
+	{
+		// The recorder and collectors are still running for a camera that left the replay world
+		UE_LOG(LogTemp, Error, TEXT("Camera %s was unregistered during its capture, discarding it"), *CameraNames[CameraIndex]);
+		ProfilerModule.AbortCaptureWindow();
+	}
+
+	if (GetDefault<UBatchProfilerSettings>()->TraceReplayCaptures)
+	{
+		FUtilities::ExecuteCommand("trace.stop");
+	}
+
+	CameraIndex++;
+	StartCamera();
+}
+
+void FReplayProfiler::Finish()
+{
+	if (!TickerHandle.IsValid())
+	{
+		return;
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+	OnComplete.ExecuteIfBound();
+}
+
+UDemoNetDriver* FReplayProfiler::GetDemoNetDriver() const
+{
+	const UWorld* World = FUtilities::GetGameWorld();
+	return World ? World->GetDemoNetDriver() : nullptr;
+}
+#pragma endregion
@@ -0,0 +1,312 @@
+#include "Capture/ThreadOccupancyCollector.h"
+#include "Utilities/ProfilerStats.h"
+#include "BatchProfilerSettings.h"
+#include "HAL/ThreadManager.h"
+#include "Utilities/Utilities.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#endif
+
+#if PLATFORM_LINUX
+#include <stdio.h>
+#endif
+
+namespace ThreadOccupancyCollector
+{
+	static const TCHAR* GameThreadGroup = TEXT("GameThread");
+	static const TCHAR* RenderThreadGroup = TEXT("RenderThread");
+	static const TCHAR* RHIThreadGroup = TEXT("RHIThread");
+	static const TCHAR* WorkerGroup = TEXT("Worker");
+	static const TCHAR* OtherGroup = TEXT("Other");
+
+	// A worker pool above this average occupancy has no headroom left for more parallel work
+	static constexpr double SaturatedWorkerPct = 80.0;
+}
+
+void FThreadOccupancyCollector::BeginBatch()
+{
+	CameraOccupancies.Reset();
+}
+
+#pragma region Capture Window
+/**
+ * @brief Samples the CPU time of every engine thread at the start of the capture window
+ * @param Camera Camera being captured
+ */
+void FThreadOccupancyCollector::BeginCapture(const AProfilingCamera* Camera)
+{
+	BATCHPROFILER_SCOPE(ThreadOccupancyBeginCapture);
+	bIsCollecting = false;
+	if (!GetDefault<UBatchProfilerSettings>()->MeasureThreadOccupancy)
+	{
+		return;
+	}
+
+	double CpuSecs;
+	if (!GetThreadCpuSeconds(GGameThreadId, CpuSecs))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Thread occupancy is not supported on this platform"));
+		return;
+	}
+
+	SampleThreads(StartSamples);
+	StartTime = FPlatformTime::Seconds();
+	bIsCollecting = true;
+}
+
+/**
+ * @brief Computes busy ratios of each thread and the parallelism of the capture window
+ * @param Summary Summary of the camera
+ */
+void FThreadOccupancyCollector::EndCapture(FCameraCaptureSummary& Summary)
+{
+	BATCHPROFILER_SCOPE(ThreadOccupancyEndCapture);
+	if (!bIsCollecting)
+	{
+		return;
+	}
+
+	bIsCollecting = false;
+
+	const double WallSecs = FPlatformTime::Seconds() - StartTime;
+	if (WallSecs <= 0.0)
+	{
+		return;
+	}
+
+	TArray<FThreadSample> EndSamples;
+	SampleThreads(EndSamples);
+
+	FCameraOccupancy Occupancy;
+	double TotalCpuSecs = 0.0;
+	double WorkerCpuSecs = 0.0;
+
+	for (const FThreadSample& EndSample : EndSamples)
+	{
+		// Threads created during the window are measured from their start
+		const FThreadSample* StartSample = StartSamples.FindByPredicate([&EndSample](const FThreadSample& Sample)
+		{
+			return Sample.ThreadId == EndSample.ThreadId;
+		});
+
+		const double CpuSecs = FMath::Max(0.0, EndSample.CpuSecs - (StartSample ? StartSample->CpuSecs : 0.0));
+		const double BusyPct = FMath::Min(100.0, CpuSecs / WallSecs * 100.0);
+		Occupancy.Threads.Add({ EndSample.Name, EndSample.Group, CpuSecs * 1000.0, BusyPct });
+		TotalCpuSecs += CpuSecs;
+
+		if (EndSample.Group == ThreadOccupancyCollector::GameThreadGroup)
+		{
+			Occupancy.GameThreadBusyPct = BusyPct;
+		}
+		else if (EndSample.Group == ThreadOccupancyCollector::RenderThreadGroup)
+		{
+			Occupancy.RenderThreadBusyPct = BusyPct;
+		}
+		else if (EndSample.Group == ThreadOccupancyCollector::RHIThreadGroup)
+		{
+			Occupancy.RHIThreadBusyPct = BusyPct;
+		}
+		else if (EndSample.Group == ThreadOccupancyCollector::WorkerGroup)
+		{
+			Occupancy.WorkerCount++;
+			Occupancy.WorkerMaxBusyPct = FMath::Max(Occupancy.WorkerMaxBusyPct, BusyPct);
+			WorkerCpuSecs += CpuSecs;
+		}
+	}
+
+	// Parallelism is the average number of busy cores
+	Occupancy.WorkerBusyPct = Occupancy.WorkerCount > 0 ? WorkerCpuSecs / (WallSecs * Occupancy.WorkerCount) * 100.0 : 0.0;
+	Occupancy.Parallelism = TotalCpuSecs / WallSecs;
+
+	// Game and render thread times exclude their idle and task sync waits, the slower of the two pipelined threads
+	// gates the frame, so its share of the frame time is the serial part of the critical path
+	const FFrameStats& FrameStats = Summary.FrameStats;
+	if (FrameStats.FrameCount > 0 && FrameStats.AvgFrameMs > 0.f)
+	{
+		const double SerialMs = FMath::Max(FrameStats.AvgGameThreadMs, FrameStats.AvgRenderThreadMs);
+		Occupancy.SerialPct = FMath::Min(100.0, SerialMs / FrameStats.AvgFrameMs * 100.0);
+	}
+
+	// Frame stats tell which thread bounds the frame, occupancy tells if more workers would help
+	if (FrameStats.FrameCount == 0)
+	{
+		Occupancy.Bottleneck = TEXT("Unknown");
+	}
+	else if (FrameStats.AvgGPUMs >= FMath::Max(FrameStats.AvgGameThreadMs, FrameStats.AvgRenderThreadMs))
+	{
+		Occupancy.Bottleneck = TEXT("GPU");
+	}
+	else if (Occupancy.WorkerBusyPct >= ThreadOccupancyCollector::SaturatedWorkerPct)
+	{
+		Occupancy.Bottleneck = TEXT("WorkersSaturated");
+	}
+	else
+	{
+		Occupancy.Bottleneck = FrameStats.AvgGameThreadMs >= FrameStats.AvgRenderThreadMs ? TEXT("GameThreadSerial") : TEXT("RenderThreadSerial");
+	}
+
+	Occupancy.Threads.Sort([](const FThreadOccupancy& A, const FThreadOccupancy& B)
+	{
+		return A.Group != B.Group ? A.Group < B.Group : A.Name < B.Name;
+	});
+
+	Summary.AddMetric(TEXT("GameThreadBusyPct"), Occupancy.GameThreadBusyPct);
+	Summary.AddMetric(TEXT("RenderThreadBusyPct"), Occupancy.RenderThreadBusyPct);
+	Summary.AddMetric(TEXT("WorkerBusyPct"), Occupancy.WorkerBusyPct);
+	Summary.AddMetric(TEXT("Parallelism"), Occupancy.Parallelism);
+	Summary.AddMetric(TEXT("SerialPct"), Occupancy.SerialPct);
+	CameraOccupancies.Add(Summary.CameraName, MoveTemp(Occupancy));
+	StartSamples.Reset();
+}
+#pragma endregion
+
+#pragma region Thread Sampling
+/**
+ * @brief Samples the CPU time of the game thread and every thread known to the thread manager
+ * @param OutSamples Samples of threads the CPU time could be read for
+ */
+void FThreadOccupancyCollector::SampleThreads(TArray<FThreadSample>& OutSamples)
+{
+	OutSamples.Reset();
+
+	TArray<TPair<uint32, FString>> Threads;
+	Threads.Emplace(GGameThreadId, TEXT("GameThread"));
+	FThreadManager::Get().ForEachThread([&Threads](const uint32 ThreadId, const FRunnableThread* Thread)
+	{
+		Threads.Emplace(ThreadId, Thread->GetThreadName());
+	});
+
+	for (const TPair<uint32, FString>& Thread : Threads)
+	{
+		double CpuSecs;
+		if (GetThreadCpuSeconds(Thread.Key, CpuSecs))
+		{
+			OutSamples.Add({ Thread.Key, Thread.Value, GetThreadGroup(Thread.Key, Thread.Value), CpuSecs });
+		}
+	}
+}
+
+/**
+ * @brief Reads the CPU time a thread has been scheduled for since it started
+ * @param ThreadId OS thread id
+ * @param OutSeconds CPU time in seconds
+ * @return If the CPU time could be read
+ */
+bool FThreadOccupancyCollector::GetThreadCpuSeconds(const uint32 ThreadId, double& OutSeconds)
+{
+#if PLATFORM_WINDOWS
+	const HANDLE ThreadHandle = ::OpenThread(THREAD_QUERY_LIMITED_INFORMATION, 0, ThreadId);
+	if (ThreadHandle == nullptr)
+	{
+		return false;
+	}
+
+	FILETIME CreationTime, ExitTime, KernelTime, UserTime;
+	const bool bSuccess = ::GetThreadTimes(ThreadHandle, &CreationTime, &ExitTime, &KernelTime, &UserTime) != 0;
+	::CloseHandle(ThreadHandle);
+
+	if (bSuccess)
+	{
+		// FILETIME is in 100 nanosecond units
+		const uint64 Kernel = (static_cast<uint64>(KernelTime.dwHighDateTime) << 32) | KernelTime.dwLowDateTime;
+		const uint64 User = (static_cast<uint64>(UserTime.dwHighDateTime) << 32) | UserTime.dwLowDateTime;
+		OutSeconds = (Kernel + User) * 1e-7;
+	}
+	return bSuccess;
+#elif PLATFORM_LINUX
+	// First field of schedstat is the time spent on a CPU in nanoseconds
+	char Path[64];
+	snprintf(Path, sizeof(Path), "/proc/self/task/%u/schedstat", ThreadId);
+
+	FILE* File = fopen(Path, "r");
+	if (File == nullptr)
+	{
+		return false;
+	}
+
+	unsigned long long RunNanoseconds = 0;
+	const bool bSuccess = fscanf(File, "%llu", &RunNanoseconds) == 1;
+	fclose(File);
+
+	if (bSuccess)
+	{
+		OutSeconds = RunNanoseconds * 1e-9;
+	}
+	return bSuccess;
+#else
+	return false;
+#endif
+}
+
+FString FThreadOccupancyCollector::GetThreadGroup(const uint32 ThreadId, const FString& ThreadName)
+{
+	if (ThreadId == GGameThreadId)
+	{
+		return ThreadOccupancyCollector::GameThreadGroup;
+	}
+	if (ThreadId == GRenderThreadId)
+	{
+		return ThreadOccupancyCollector::RenderThreadGroup;
+	}
+	if (ThreadId == GRHIThreadId)
+	{
+		return ThreadOccupancyCollector::RHIThreadGroup;
+	}
+
+	// Task graph threads (TaskGraphThreadNP/HP/BP) and the low level task scheduler workers (Foreground/Background Worker)
+	if (ThreadName.StartsWith(TEXT("TaskGraphThread")) || ThreadName.Contains(TEXT("Worker")))
+	{
+		return ThreadOccupancyCollector::WorkerGroup;
+	}
+
+	return ThreadOccupancyCollector::OtherGroup;
+}
+#pragma endregion
+
+#pragma region Report
+/**
+ * @brief Writes the per thread occupancy and the parallelism summary of each camera
+ * @param Summaries Summaries of the batch
+ */
+void FThreadOccupancyCollector::CompleteBatch(const TArray<FCameraCaptureSummary>& Summaries)
+{
+	if (CameraOccupancies.Num() == 0)
+	{
+		return;
+	}
+
+	FString Threads = TEXT("Camera,Thread,Group,CpuMs,BusyPct\n");
+	FString Parallelism = TEXT("Camera,GameThreadBusyPct,RenderThreadBusyPct,RHIThreadBusyPct,Workers,WorkerBusyPct,WorkerMaxBusyPct,Parallelism,SerialPct,Bottleneck\n");
+
+	for (const FCameraCaptureSummary& Summary : Summaries)
+	{
+		const FCameraOccupancy* Occupancy = CameraOccupancies.Find(Summary.CameraName);
+		if (Occupancy == nullptr)
+		{
+			continue;
+		}
+
+		for (const FThreadOccupancy& Thread : Occupancy->Threads)
+		{
+			Threads += FString::Printf(TEXT("%s,%s,%s,%.2f,%.2f\n"), *Summary.CameraName, *Thread.Name, *Thread.Group, Thread.CpuMs, Thread.BusyPct);
+		}
+
+		Parallelism += FString::Printf(TEXT("%s,%.2f,%.2f,%.2f,%d,%.2f,%.2f,%.2f,%.2f,%s\n"),
+			*Summary.CameraName,
+			Occupancy->GameThreadBusyPct,
+			Occupancy->RenderThreadBusyPct,
+			Occupancy->RHIThreadBusyPct,
+			Occupancy->WorkerCount,
+			Occupancy->WorkerBusyPct,
+			Occupancy->WorkerMaxBusyPct,
+			Occupancy->Parallelism,
+			Occupancy->SerialPct,
+			*Occupancy->Bottleneck);
+	}
+
+	const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y.%m.%d_%H.%M"));
+	FUtilities::SaveReport(FString::Printf(TEXT("ThreadOccupancy_%s.csv"), *Timestamp), Threads);
+	FUtilities::SaveReport(FString::Printf(TEXT("ThreadOccupancy_%s_Parallelism.csv"), *Timestamp), Parallelism);
+}
+#pragma endregion
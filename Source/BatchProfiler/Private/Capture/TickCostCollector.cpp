@@ -0,0 +1,374 @@
+#include "Capture/TickCostCollector.h"
+#include "Utilities/ProfilerStats.h"
+#include "BatchProfilerSettings.h"
+#include "EngineUtils.h"
+#include "Engine/Engine.h"
+#include "ProfilingCamera.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Stats/StatsData.h"
+#include "Utilities/Utilities.h"
+
+namespace TickCostCollector
+{
+	static const TCHAR* ActorCategory = TEXT("Actor");
+	static const TCHAR* ComponentCategory = TEXT("Component");
+	static const TCHAR* NiagaraCategory = TEXT("Niagara");
+	static const TCHAR* AnimationCategory = TEXT("Animation");
+
+	static bool IsNiagaraComponent(const UObject* Object)
+	{
+		for (const UClass* Class = Object->GetClass(); Class; Class = Class->GetSuperClass())
+		{
+			if (Class->GetFName() == TEXT("NiagaraComponent"))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+FTickCostCollector::~FTickCostCollector()
+{
+	StopCollecting();
+}
+
+void FTickCostCollector::BeginBatch()
+{
+	CameraTickCosts.Reset();
+}
+
+#pragma region Capture Window
+/**
+ * @brief Maps tick functions of the world to their stat ids and starts aggregating stats frames
+ * @param Camera Camera being captured
+ */
+void FTickCostCollector::BeginCapture(const AProfilingCamera* Camera)
+{
+	BATCHPROFILER_SCOPE(TickCostBeginCapture);
+	if (!GetDefault<UBatchProfilerSettings>()->AttributeTickCost)
+	{
+		return;
+	}
+
+#if STATS
+	StopCollecting();
+	MapTickTargets(Camera->GetWorld());
+
+	// Per object cycle stats are only emitted while stats are being collected
+	StatsPrimaryEnableAdd();
+	FUtilities::ExecuteCommand("stat group enable UObjects");
+
+	RunOnStatsThread(FSimpleDelegate::CreateRaw(this, &FTickCostCollector::AddNewFrameHandler));
+	bIsCollecting = true;
+#else
+	UE_LOG(LogTemp, Warning, TEXT("Tick cost attribution requires a build with stats enabled"));
+#endif
+}
+
+/**
+ * @brief Stops aggregating and ranks tick costs of the capture window
+ * @param Summary Summary of the camera
+ */
+void FTickCostCollector::EndCapture(FCameraCaptureSummary& Summary)
+{
+	BATCHPROFILER_SCOPE(TickCostEndCapture);
+	if (!bIsCollecting)
+	{
+		return;
+	}
+
+	StopCollecting();
+
+	FScopeLock ScopeLock(&CollectLock);
+
+	TMap<FString, FTickCost> GroupedCosts;
+	for (const TPair<FName, FTickTarget>& StatTarget : StatTargets)
+	{
+		const FString GroupKey = StatTarget.Value.Category + TEXT("|") + StatTarget.Value.Name;
+		FTickCost& Cost = GroupedCosts.FindOrAdd(GroupKey);
+		Cost.Category = StatTarget.Value.Category;
+		Cost.Name = StatTarget.Value.Name;
+		Cost.Instances++;
+
+		if (const double* Milliseconds = StatMilliseconds.Find(StatTarget.Key))
+		{
+			Cost.MsPerFrame += StatFrameCount > 0 ? *Milliseconds / StatFrameCount : 0.0;
+		}
+	}
+
+	TArray<FTickCost> RankedCosts;
+	GroupedCosts.GenerateValueArray(RankedCosts);
+	RankedCosts.Sort([](const FTickCost& A, const FTickCost& B)
+	{
+		return A.MsPerFrame != B.MsPerFrame ? A.MsPerFrame > B.MsPerFrame : A.Name < B.Name;
+	});
+
+	double TotalMsPerFrame = 0.0;
+	for (const FTickCost& Cost : RankedCosts)
+	{
+		TotalMsPerFrame += Cost.MsPerFrame;
+	}
+
+	Summary.AddMetric(TEXT("TickMs"), TotalMsPerFrame);
+
+	// Per object cycle stats inflate the game thread, frame times of this summary are not comparable to captures without them
+	Summary.AddMetric(TEXT("TickCostSkewed"), 1.0);
+	CameraTickCosts.Add(Summary.CameraName, MoveTemp(RankedCosts));
+
+	StatTargets.Reset();
+	StatMilliseconds.Reset();
+}
+
+void FTickCostCollector::StopCollecting()
+{
+#if STATS
+	if (bIsCollecting)
+	{
+		RunOnStatsThread(FSimpleDelegate::CreateRaw(this, &FTickCostCollector::RemoveNewFrameHandler));
+		// Leaving the group enabled would add per object stats to every later capture
+		if (GEngine)
+		{
+			FUtilities::ExecuteCommand("stat group disable UObjects");
+		}
+		StatsPrimaryEnableSubtract();
+		bIsCollecting = false;
+	}
+#endif
+}
+
+#if STATS
+/**
+ * @brief Runs a task where the stats delegates are broadcast and waits for it, so no frame is delivered after removal
+ * @param Task Task to run
+ */
+void FTickCostCollector::RunOnStatsThread(const FSimpleDelegate& Task)
+{
+	const ENamedThreads::Type StatsThread = FPlatformProcess::SupportsMultithreading() ? ENamedThreads::StatsThread : ENamedThreads::GameThread;
+	const FGraphEventRef TaskEvent = TGraphTask<FSimpleDelegateGraphTask>::CreateTask().ConstructAndDispatchWhenReady(Task, TStatId(), StatsThread);
+	FTaskGraphInterface::Get().WaitUntilTaskCompletes(TaskEvent, ENamedThreads::GameThread);
+}
+
+void FTickCostCollector::AddNewFrameHandler()
+{
+	NewFrameHandle = FStatsThreadState::GetLocalState().NewFrameDelegate.AddRaw(this, &FTickCostCollector::OnNewStatsFrame);
+}
+
+void FTickCostCollector::RemoveNewFrameHandler()
+{
+	FStatsThreadState::GetLocalState().NewFrameDelegate.Remove(NewFrameHandle);
+	NewFrameHandle.Reset();
+}
+#endif
+#pragma endregion
+
+#pragma region Stats Aggregation
+/**
+ * @brief Maps stat ids of every ticking actor and component to the class or asset they are attributed to
+ * @param World World of the captured camera
+ */
+void FTickCostCollector::MapTickTargets(const UWorld* World)
+{
+	FScopeLock ScopeLock(&CollectLock);
+	StatTargets.Reset();
+	StatMilliseconds.Reset();
+	StatFrameCount = 0;
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		const AActor* Actor = *It;
+		if (Actor->PrimaryActorTick.IsTickFunctionRegistered())
+		{
+			AddTickTarget(Actor, TickCostCollector::ActorCategory, Actor->GetClass()->GetName());
+		}
+
+		for (const UActorComponent* Component : Actor->GetComponents())
+		{
+			if (Component == nullptr || !Component->PrimaryComponentTick.IsTickFunctionRegistered())
+			{
+				continue;
+			}
+
+			if (TickCostCollector::IsNiagaraComponent(Component))
+			{
+				// Resolved through reflection to avoid depending on the Niagara plugin
+				const FObjectProperty* AssetProperty = FindFProperty<FObjectProperty>(Component->GetClass(), TEXT("Asset"));
+				const UObject* System = AssetProperty ? AssetProperty->GetObjectPropertyValue_InContainer(Component) : nullptr;
+				AddTickTarget(Component, TickCostCollector::NiagaraCategory, System ? System->GetName() : TEXT("None"));
+			}
+			else if (const USkeletalMeshComponent* SkeletalMeshComponent = Cast<USkeletalMeshComponent>(Component))
+			{
+				const USkeletalMesh* SkeletalMesh = SkeletalMeshComponent->GetSkeletalMeshAsset();
+				AddTickTarget(Component, TickCostCollector::AnimationCategory, SkeletalMesh ? SkeletalMesh->GetName() : TEXT("None"));
+			}
+			else
+			{
+				AddTickTarget(Component, TickCostCollector::ComponentCategory, Component->GetClass()->GetName());
+			}
+		}
+	}
+}
+
+void FTickCostCollector::AddTickTarget(const UObject* Object, const FString& Category, const FString& Name)
+{
+#if STATS
+	const FName StatName = Object->GetStatID(true).GetName();
+	if (!StatName.IsNone())
+	{
+		StatTargets.Add(StatName, { Category, Name });
+	}
+#endif
+}
+
+/**
+ * @brief Accumulates inclusive time of mapped object stats for a stats frame (stats thread)
+ * @param Frame Stats frame
+ */
+void FTickCostCollector::OnNewStatsFrame(const int64 Frame)
+{
+	BATCHPROFILER_SCOPE(TickCostStatsFrame);
+#if STATS
+	const FStatsThreadState& StatsState = FStatsThreadState::GetLocalState();
+	if (!StatsState.IsFrameValid(Frame))
+	{
+		return;
+	}
+
+	TArray<FStatMessage> Stats;
+	StatsState.GetInclusiveAggregateStackStats(Frame, Stats);
+
+	FScopeLock ScopeLock(&CollectLock);
+	for (const FStatMessage& Stat : Stats)
+	{
+		const FName StatName = Stat.NameAndInfo.GetRawName();
+		if (!StatTargets.Contains(StatName))
+		{
+			continue;
+		}
+
+		const int64 Cycles = Stat.NameAndInfo.GetFlag(EStatMetaFlags::IsPackedCCAndDuration)
+			? FromPackedCallCountDuration_Duration(Stat.GetValue_int64())
+			: Stat.GetValue_Duration();
+		StatMilliseconds.FindOrAdd(StatName) += FPlatformTime::ToMilliseconds64(Cycles);
+	}
+
+	StatFrameCount++;
+#endif
+}
+#pragma endregion
+
+#pragma region Report
+/**
+ * @brief Writes the ranked tick costs of each camera and a class by camera table for diffing
+ * @param Summaries Summaries of the batch
+ */
+void FTickCostCollector::CompleteBatch(const TArray<FCameraCaptureSummary>& Summaries)
+{
+	if (CameraTickCosts.Num() == 0)
+	{
+		return;
+	}
+
+	const int TopCount = GetDefault<UBatchProfilerSettings>()->TickCostTopCount;
+
+	FString Ranked = TEXT("Camera,Rank,Category,Name,Instances,MsPerFrame\n");
+	TMap<FString, TMap<FString, float>> CostsByName;
+	TArray<FString> CameraNames;
+
+	for (const FCameraCaptureSummary& Summary : Summaries)
+	{
+		const TArray<FTickCost>* Costs = CameraTickCosts.Find(Summary.CameraName);
+		if (Costs == nullptr)
+		{
+			continue;
+		}
+
+		CameraNames.Add(Summary.CameraName);
+		for (int32 Rank = 0; Rank < Costs->Num(); ++Rank)
+		{
+			const FTickCost& Cost = (*Costs)[Rank];
+			if (Rank < TopCount)
+			{
+				Ranked += FString::Printf(TEXT("%s,%d,%s,%s,%d,%.4f\n"), *Summary.CameraName, Rank + 1, *Cost.Category, *Cost.Name, Cost.Instances, Cost.MsPerFrame);
+			}
+
+			CostsByName.FindOrAdd(Cost.Category + TEXT(",") + Cost.Name).Add(Summary.CameraName, Cost.MsPerFrame);
+		}
+	}
+
+	// One row per class, one column per camera, plus the spread between cheapest and most expensive camera
+	FString Diff = TEXT("Category,Name");
+	for (const FString& CameraName : CameraNames)
+	{
+		Diff += TEXT(",") + CameraName;
+	}
+	Diff += TEXT(",Spread\n");
+
+	CostsByName.KeySort(TLess<FString>());
+	for (const TPair<FString, TMap<FString, float>>& Row : CostsByName)
+	{
+		float MinMs = TNumericLimits<float>::Max();
+		float MaxMs = 0.f;
+
+		Diff += Row.Key;
+		for (const FString& CameraName : CameraNames)
+		{
+			const float Ms = Row.Value.FindRef(CameraName);
+			MinMs = FMath::Min(MinMs, Ms);
+			MaxMs = FMath::Max(MaxMs, Ms);
+			Diff += FString::Printf(TEXT(",%.4f"), Ms);
+		}
+		Diff += FString::Printf(TEXT(",%.4f\n"), MaxMs - MinMs);
+	}
+
+	const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y.%m.%d_%H.%M"));
+	FUtilities::SaveReport(FString::Printf(TEXT("TickCost_%s.csv"), *Timestamp), Ranked);
+	FUtilities::SaveReport(FString::Printf(TEXT("TickCost_%s_Diff.csv"), *Timestamp), Diff);
+}
+
+/**
+ * @brief Logs classes with the largest tick cost difference between two cameras of the last batch
+ * @param CameraA Reference camera
+ * @param CameraB Compared camera
+ */
+void FTickCostCollector::LogDiff(const FString& CameraA, const FString& CameraB) const
+{
+	const TArray<FTickCost>* CostsA = CameraTickCosts.Find(CameraA);
+	const TArray<FTickCost>* CostsB = CameraTickCosts.Find(CameraB);
+	if (CostsA == nullptr || CostsB == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No tick costs captured for %s or %s"), *CameraA, *CameraB);
+		return;
+	}
+
+	TMap<FString, float> Deltas;
+	for (const FTickCost& Cost : *CostsB)
+	{
+		Deltas.FindOrAdd(Cost.Category + TEXT(" ") + Cost.Name) += Cost.MsPerFrame;
+	}
+	for (const FTickCost& Cost : *CostsA)
+	{
+		Deltas.FindOrAdd(Cost.Category + TEXT(" ") + Cost.Name) -= Cost.MsPerFrame;
+	}
+
+	Deltas.ValueSort([](const float A, const float B)
+	{
+		return FMath::Abs(A) > FMath::Abs(B);
+	});
+
+	const int TopCount = GetDefault<UBatchProfilerSettings>()->TickCostTopCount;
+	int32 Rank = 0;
+	UE_LOG(LogTemp, Display, TEXT("Tick cost difference %s -> %s"), *CameraA, *CameraB);
+	for (const TPair<FString, float>& Delta : Deltas)
+	{
+		if (Rank++ >= TopCount)
+		{
+			break;
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("%s: %+.4f ms"), *Delta.Key, Delta.Value);
+	}
+}
+#pragma endregion
@@ -0,0 +1,196 @@
+#include "Capture/TraceChannelCalibrator.h"
+#include "Utilities/ProfilerStats.h"
+#include "BatchProfilerSettings.h"
+#include "Trace/Trace.h"
+#include "Utilities/TraceChannels.h"
+#include "Utilities/Utilities.h"
+
+namespace TraceChannelCalibrator
+{
+	static const TCHAR* BaselineChannel = TEXT("None");
+	static const TCHAR* DefaultChannel = TEXT("default");
+	static constexpr float WarmupSecs = 1.0f;
+}
+
+FTraceChannelCalibrator::FTraceChannelCalibrator(const FString& InCameraName, const float InSettleSecs, const float InMeasureSecs)
+	: CameraName(InCameraName), SettleSecs(InSettleSecs), MeasureSecs(InMeasureSecs)
+{
+	const TArray<FString> RegisteredChannels = FTraceChannels::GetRegisteredChannels();
+	const auto IsRegistered = [&RegisteredChannels](const FString& ChannelName)
+	{
+		return RegisteredChannels.ContainsByPredicate([&ChannelName](const FString& Registered)
+		{
+			return Registered.Equals(ChannelName, ESearchCase::IgnoreCase);
+		});
+	};
+
+	// Baseline without tracing, then the default set, then each channel on its own
+	FCalibrationStep BaselineStep;
+	BaselineStep.ChannelName = TraceChannelCalibrator::BaselineChannel;
+	Steps.Add(BaselineStep);
+
+	FCalibrationStep DefaultStep;
+	DefaultStep.ChannelName = TraceChannelCalibrator::DefaultChannel;
+	Steps.Add(DefaultStep);
+
+	const UEnum* TraceEnum = StaticEnum<EProfilingTraceChannel>();
+	for (int32 EnumIndex = 0; EnumIndex < TraceEnum->NumEnums() - 1; ++EnumIndex)
+	{
+		const EProfilingTraceChannel Channel = static_cast<EProfilingTraceChannel>(TraceEnum->GetValueByIndex(EnumIndex));
+
+		FCalibrationStep Step;
+		Step.ChannelName = FTraceChannels::GetChannelName(Channel);
+		Step.bIsRegistered = IsRegistered(Step.ChannelName);
+		Steps.Add(Step);
+	}
+}
+
+FTraceChannelCalibrator::~FTraceChannelCalibrator()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	}
+}
+
+/**
+ * @brief Starts calibration on the active view
+ * @param InOnComplete Called after the report is written
+ */
+void FTraceChannelCalibrator::Start(const FSimpleDelegate& InOnComplete)
+{
+	OnComplete = InOnComplete;
+	StepIndex = 0;
+
+	// Make sure nothing is being traced while measuring the baseline
+	FUtilities::ExecuteCommand("trace.stop");
+
+	Phase = EPhase::Settle;
+	PhaseEndTime = FPlatformTime::Seconds() + SettleSecs;
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FTraceChannelCalibrator::Tick));
+}
+
+bool FTraceChannelCalibrator::Tick(float DeltaTime)
+{
+	BATCHPROFILER_SCOPE(CalibratorTick);
+	const double Now = FPlatformTime::Seconds();
+	if (Now < PhaseEndTime)
+	{
+		return true;
+	}
+
+	switch (Phase)
+	{
+	case EPhase::Settle:
+		StartStep();
+		break;
+
+	case EPhase::Warmup:
+		MeasureStartBytes = GetTracedBytes();
+		Recorder.Start();
+		Phase = EPhase::Measure;
+		PhaseEndTime = Now + MeasureSecs;
+		break;
+
+	case EPhase::Measure:
+		FinishStep();
+		break;
+	}
+
+	if (StepIndex >= Steps.Num())
+	{
+		TickerHandle.Reset();
+		WriteReport();
+		OnComplete.ExecuteIfBound();
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Starts tracing the channel of the current step, skipping unregistered channels
+ */
+void FTraceChannelCalibrator::StartStep()
+{
+	while (Steps.IsValidIndex(StepIndex) && !Steps[StepIndex].bIsRegistered)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Trace channel %s is not registered, skipping calibration"), *Steps[StepIndex].ChannelName);
+		++StepIndex;
+	}
+
+	if (!Steps.IsValidIndex(StepIndex))
+	{
+		return;
+	}
+
+	const FCalibrationStep& Step = Steps[StepIndex];
+	UE_LOG(LogTemp, Display, TEXT("Calibrating Trace Channel: %s"), *Step.ChannelName);
+
+	if (StepIndex > 0)
+	{
+		const FString TraceCommand = FString::Printf(TEXT("trace.file %s_Calibration_%s %s"), *CameraName, *Step.ChannelName, *Step.ChannelName);
+		FUtilities::ExecuteCommand(TraceCommand);
+	}
+
+	Phase = EPhase::Warmup;
+	PhaseEndTime = FPlatformTime::Seconds() + TraceChannelCalibrator::WarmupSecs;
+}
+
+/**
+ * @brief Stores the measurement of the current step and moves to the next one
+ */
+void FTraceChannelCalibrator::FinishStep()
+{
+	FCalibrationStep& Step = Steps[StepIndex];
+	Step.FrameStats = Recorder.Stop();
+
+	if (StepIndex > 0)
+	{
+		const uint64 TracedBytes = GetTracedBytes() - MeasureStartBytes;
+		Step.BytesPerSec = Step.FrameStats.DurationSecs > 0.0 ? TracedBytes / Step.FrameStats.DurationSecs : 0.0;
+		FUtilities::ExecuteCommand("trace.stop");
+	}
+
+	++StepIndex;
+	StartStep();
+}
+
+/**
+ * @brief Writes overhead of each channel compared to the baseline as csv
+ */
+void FTraceChannelCalibrator::WriteReport() const
+{
+	const FFrameStats& Baseline = Steps[0].FrameStats;
+
+	FString Report = TEXT("Channel,Registered,AvgFrameMs,P95FrameMs,OverheadMs,OverheadPct,BytesPerSec\n");
+	for (const FCalibrationStep& Step : Steps)
+	{
+		if (!Step.bIsRegistered)
+		{
+			Report += FString::Printf(TEXT("%s,false,,,,,\n"), *Step.ChannelName);
+			continue;
+		}
+
+		const float OverheadMs = Step.FrameStats.AvgFrameMs - Baseline.AvgFrameMs;
+		const float OverheadPct = Baseline.AvgFrameMs > 0.f ? 100.f * OverheadMs / Baseline.AvgFrameMs : 0.f;
+		Report += FString::Printf(TEXT("%s,true,%.3f,%.3f,%.3f,%.2f,%.0f\n"),
+			*Step.ChannelName, Step.FrameStats.AvgFrameMs, Step.FrameStats.P95FrameMs, OverheadMs, OverheadPct, Step.BytesPerSec);
+
+		UE_LOG(LogTemp, Display, TEXT("Trace Channel %s: %+.3f ms (%+.2f%%), %.0f bytes/sec"),
+			*Step.ChannelName, OverheadMs, OverheadPct, Step.BytesPerSec);
+	}
+
+	const FString ReportName = FString::Printf(TEXT("TraceCalibration_%s_%s.csv"), *CameraName, *FDateTime::Now().ToString(TEXT("%Y.%m.%d_%H.%M")));
+	FUtilities::SaveReport(ReportName, Report);
+}
+
+/**
+ * @brief Returns the total amount of bytes emitted by trace so far
+ */
+uint64 FTraceChannelCalibrator::GetTracedBytes()
+{
+	UE::Trace::FStatistics Statistics;
+	UE::Trace::GetStatistics(Statistics);
+	return Statistics.BytesTraced;
+}
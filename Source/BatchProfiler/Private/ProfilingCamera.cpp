@@ -4,6 +4,8 @@
 #include "BatchProfiler.h"
 #include "Camera/CameraComponent.h"
 #include "GameFramework/PlayerController.h"
+#include "Utilities/ProfilerStats.h"
+#include "Utilities/TraceChannels.h"
 #include "Utilities/Utilities.h"
 #include "BatchProfilerSettings.h"
 
@@ -106,6 +108,7 @@ void AProfilingCamera::UnregisterCamera()
 #pragma region Camera Activation
 void AProfilingCamera::ActivateCamera()
 {
+	BATCHPROFILER_SCOPE(ActivateCamera);
 	if (ProfilingCameraComponent && ProfilingCameraComponent->IsValidLowLevel())
 	{
 		ProfilingCameraComponent->Activate();
@@ -129,6 +132,7 @@ void AProfilingCamera::DeactivateCamera() const
 #pragma region UE Insight Capture
 void AProfilingCamera::StartInsightCapture(const float CaptureSecs, bool IsBatch, bool IsSnapshot)
 {
+	BATCHPROFILER_SCOPE(StartInsightCapture);
 	// Early exit if conditions are not met
 	if (!(ProfilingCameraComponent && ProfilingCameraComponent->IsValidLowLevel()))
 	{
@@ -138,25 +142,29 @@ void AProfilingCamera::StartInsightCapture(const float CaptureSecs, bool IsBatch
 	UE_LOG(LogTemp, Warning, TEXT("Capturing From: %s"), *CameraName)
 
 	// Activate camera
+	ProfilerModule->BeginCameraArrival(this);
 	ActivateCamera();
 
 	// Show camera name on screen
 	const float Delay = BatchProfilerSettings->DelayBeforeEachCapture;
-	GEngine->AddOnScreenDebugMessage(31419, Delay + 1.0f, FColor::Green, FString::Printf(TEXT("Current Camera: %s"), *CameraName));
+	if (BatchProfilerSettings->ShowCameraNameOnScreen)
+	{
+		GEngine->AddOnScreenDebugMessage(31419, Delay + 1.0f, FColor::Green, FString::Printf(TEXT("Current Camera: %s"), *CameraName));
+	}
 
 	// Capture after delay defined in Project Settings
-	FTimerHandle DelayInsightCaptureHandle;
 	FTimerDelegate DelayInsightCaptureDelegate;
 	DelayInsightCaptureDelegate.BindLambda([this, CaptureSecs, IsBatch, IsSnapshot]() {
 		CaptureInsight(CaptureSecs, IsBatch, IsSnapshot);
 	});
 	
 	// Set up a timer to call the bound function after a delay
-	GetWorldTimerManager().SetTimer(DelayInsightCaptureHandle, DelayInsightCaptureDelegate, Delay, false);
+	GetWorldTimerManager().SetTimer(DelayTimerHandle, DelayInsightCaptureDelegate, Delay, false);
 }
 
 void AProfilingCamera::CaptureInsight(const float CaptureSecs, bool IsBatch, bool IsSnapshot) const
 {
+	BATCHPROFILER_SCOPE(CaptureInsight);
 	// Take snapshot and save
 	const FString FileName = GetFilename();
 
@@ -167,23 +175,19 @@ void AProfilingCamera::CaptureInsight(const float CaptureSecs, bool IsBatch, boo
 	}
 	else
 	{
-		FString EnabledTraceChannels;
-		const UEnum* TraceEnumPtr = FindObject<UEnum>(ANY_PACKAGE, TEXT("EProfilingTraceChannel"), true);
-		for (const EProfilingTraceChannel TraceChannel : BatchProfilerSettings->TraceSettings.EnabledTraceChannels)
-		{
-			FString TraceChannelString = TraceEnumPtr->GetDisplayNameTextByValue(static_cast<int64>(TraceChannel)).ToString();
-			EnabledTraceChannels += TraceChannelString + TEXT(" ");
-		}
-		
+		const FString EnabledTraceChannels = FTraceChannels::BuildChannelSet(BatchProfilerSettings->TraceSettings.EnabledTraceChannels);
 		const FString TraceCommand = FString::Printf(TEXT("trace.file %s_Trace %s"), *FileName, *EnabledTraceChannels);
 		FUtilities::ExecuteCommand(TraceCommand);
 		FUtilities::ExecuteCommand("trace.screenshot");
 	}
+
+	ProfilerModule->BeginCaptureWindow(this);
 	
 	// Call StopInsight after 1 seconds
-	FTimerHandle CaptureTimerHandle;
 	FTimerDelegate StopInsightDelegate;
 	StopInsightDelegate.BindLambda([this, CaptureSecs, IsBatch, IsSnapshot]() {
+		ProfilerModule->EndCaptureWindow(this);
+
 		if (IsBatch)
 		{
 			const AProfilingCamera* NextCamera = ProfilerModule->GetNextCamera();
@@ -221,6 +225,7 @@ void AProfilingCamera::CaptureInsight(const float CaptureSecs, bool IsBatch, boo
 #pragma region RenderDoc Capture
 void AProfilingCamera::StartRenderDoc(const int FrameCount, bool IsBatch)
 {
+	BATCHPROFILER_SCOPE(StartRenderDoc);
 	// Early exit if conditions are not met
 	if (!(ProfilingCameraComponent && ProfilingCameraComponent->IsValidLowLevel()))
 	{
@@ -234,27 +239,29 @@ void AProfilingCamera::StartRenderDoc(const int FrameCount, bool IsBatch)
 
 	// Show Camera Name On Screen
 	const float Delay = BatchProfilerSettings->DelayBeforeEachCapture;
-	GEngine->AddOnScreenDebugMessage(31419, Delay + 1.0f, FColor::Green, FString::Printf(TEXT("Current Camera: %s"), *CameraName));
+	if (BatchProfilerSettings->ShowCameraNameOnScreen)
+	{
+		GEngine->AddOnScreenDebugMessage(31419, Delay + 1.0f, FColor::Green, FString::Printf(TEXT("Current Camera: %s"), *CameraName));
+	}
 
 	// Capture after delay defined in Project Settings
-	FTimerHandle DelayRenderDocCaptureHandle;
 	FTimerDelegate DelayRenderDocCaptureDelegate;
 	DelayRenderDocCaptureDelegate.BindLambda([this, FrameCount, IsBatch]() {
 		CaptureRenderDoc(FrameCount, IsBatch);
 	});
 	
 	// Set up a timer to call the bound function after a delay
-	GetWorldTimerManager().SetTimer(DelayRenderDocCaptureHandle, DelayRenderDocCaptureDelegate, Delay, false);
+	GetWorldTimerManager().SetTimer(DelayTimerHandle, DelayRenderDocCaptureDelegate, Delay, false);
 }
 
 void AProfilingCamera::CaptureRenderDoc(const int FrameCount, bool IsBatch) const
 {
+	BATCHPROFILER_SCOPE(CaptureRenderDoc);
 	// Execute RenderDoc capture
 	const FString Command = FString::Printf(TEXT("renderdoc.CaptureFrame %i"), FrameCount);
 	FUtilities::ExecuteCommand(Command);
 	
 	// Try get next camera after 1 seconds of delay
-	FTimerHandle CaptureTimerHandle;
 	FTimerDelegate StopRenderDocDelegate;
 	StopRenderDocDelegate.BindLambda([this, FrameCount, IsBatch]() {
 		if (IsBatch)
@@ -278,49 +285,78 @@ void AProfilingCamera::CaptureRenderDoc(const int FrameCount, bool IsBatch) cons
 	GetWorldTimerManager().SetTimer(CaptureTimerHandle, StopRenderDocDelegate, 1.0f, false);
 }
 
+/**
+ * @brief Clears pending capture timers of the camera, used when a capture stalls
+ */
+void AProfilingCamera::CancelCapture()
+{
+	GetWorldTimerManager().ClearTimer(DelayTimerHandle);
+	GetWorldTimerManager().ClearTimer(CaptureTimerHandle);
+}
+
 FString AProfilingCamera::GetFilename() const
 {
-	const FString NameTokens = BatchProfilerSettings->InsightsFilenameTokens;
-	FString ProcessedName = NameTokens;
-	
+	BATCHPROFILER_SCOPE(GetFilename);
+
+	const FString& NameTokens = BatchProfilerSettings->InsightsFilenameTokens;
 	const FDateTime DateTime = FDateTime::Now();
 
-	if (ProcessedName.Contains("{CameraName}"))
-	{
-		ProcessedName = ProcessedName.Replace(TEXT("{CameraName}"), *CameraName, ESearchCase::IgnoreCase);
-	}
-	
-	if (ProcessedName.Contains(TEXT("{Year}")))
-	{
-		const FString Year = FString::Printf(TEXT("%04d"), DateTime.GetYear());
-		ProcessedName = ProcessedName.Replace(TEXT("{Year}"), *Year, ESearchCase::IgnoreCase);
-	}
-	
-	if (ProcessedName.Contains(TEXT("{Month}")))
-	{
-		const FString Month = FString::Printf(TEXT("%02d"), DateTime.GetMonth());
-		ProcessedName = ProcessedName.Replace(TEXT("{Month}"), *Month, ESearchCase::IgnoreCase);
-	}
-	
-	if (ProcessedName.Contains(TEXT("{Day}")))
-	{
-		const FString Day = FString::Printf(TEXT("%02d"), DateTime.GetDay());
-		ProcessedName = ProcessedName.Replace(TEXT("{Day}"), *Day, ESearchCase::IgnoreCase);
-	}
-	
-	if (ProcessedName.Contains(TEXT("{Hour}")))
-	{
-		const FString Hour = FString::Printf(TEXT("%02d"), DateTime.GetHour());
-		ProcessedName = ProcessedName.Replace(TEXT("{Hour}"), *Hour, ESearchCase::IgnoreCase);
-	}
-	
-	if (ProcessedName.Contains(TEXT("{Minute}")))
+	// Tokens are replaced in a single pass, unknown tokens are kept as they are
+	FString ProcessedName;
+	ProcessedName.Reserve(NameTokens.Len() + CameraName.Len());
+
+	int32 Index = 0;
+	while (Index < NameTokens.Len())
 	{
-		const FString Minute = FString::Printf(TEXT("%02d"), DateTime.GetMinute());
-		ProcessedName = ProcessedName.Replace(TEXT("{Minute}"), *Minute, ESearchCase::IgnoreCase);
+		int32 TokenEnd = NameTokens[Index] == TEXT('{') ? NameTokens.Find(TEXT("}"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Index) : INDEX_NONE;
+
+		// A brace inside the span means the first brace is a literal, the token starts at a later brace
+		const int32 NextTokenStart = TokenEnd != INDEX_NONE ? NameTokens.Find(TEXT("{"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Index + 1) : INDEX_NONE;
+		if (NextTokenStart != INDEX_NONE && NextTokenStart < TokenEnd)
+		{
+			TokenEnd = INDEX_NONE;
+		}
+
+		if (TokenEnd == INDEX_NONE)
+		{
+			ProcessedName.AppendChar(NameTokens[Index++]);
+			continue;
+		}
+
+		const FString Token = NameTokens.Mid(Index + 1, TokenEnd - Index - 1);
+		if (Token.Equals(TEXT("CameraName"), ESearchCase::IgnoreCase))
+		{
+			ProcessedName += CameraName;
+		}
+		else if (Token.Equals(TEXT("Year"), ESearchCase::IgnoreCase))
+		{
+			ProcessedName += FString::Printf(TEXT("%04d"), DateTime.GetYear());
+		}
+		else if (Token.Equals(TEXT("Month"), ESearchCase::IgnoreCase))
+		{
+			ProcessedName += FString::Printf(TEXT("%02d"), DateTime.GetMonth());
+		}
+		else if (Token.Equals(TEXT("Day"), ESearchCase::IgnoreCase))
+		{
+			ProcessedName += FString::Printf(TEXT("%02d"), DateTime.GetDay());
+		}
+		else if (Token.Equals(TEXT("Hour"), ESearchCase::IgnoreCase))
+		{
+			ProcessedName += FString::Printf(TEXT("%02d"), DateTime.GetHour());
+		}
+		else if (Token.Equals(TEXT("Minute"), ESearchCase::IgnoreCase))
+		{
+			ProcessedName += FString::Printf(TEXT("%02d"), DateTime.GetMinute());
+		}
+		else
+		{
+			ProcessedName += NameTokens.Mid(Index, TokenEnd - Index + 1);
+		}
+
+		Index = TokenEnd + 1;
 	}
-	
-	return *ProcessedName;
+
+	return ProcessedName;
 }
 #pragma endregion
 
@@ -0,0 +1,405 @@
+#include "Service/ProfilingService.h"
+#include "Utilities/ProfilerStats.h"
+#include "BatchProfiler.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Utilities/Utilities.h"
+
+namespace ProfilingService
+{
+	static const TCHAR* QueueFolder = TEXT("Queue");
+	static const TCHAR* RunningFolder = TEXT("Running");
+	static const TCHAR* DoneFolder = TEXT("Done");
+	static const TCHAR* FailedFolder = TEXT("Failed");
+
+	static constexpr double PollIntervalSecs = 1.0;
+	static constexpr double MapLoadTimeoutSecs = 600.0;
+	static constexpr double CameraTimeoutSecs = 30.0;
+
+	// Added to the expected batch duration before a capturing job is considered hung
+	static constexpr double CaptureTimeoutMarginSecs = 120.0;
+}
+
+FProfilingService::FProfilingService(FBatchProfilerModule& InProfilerModule)
+	: ProfilerModule(InProfilerModule)
+{
+}
+
+FProfilingService::~FProfilingService()
+{
+	Stop();
+}
+
+/**
+ * @brief Default spool directory (Saved/BatchProfiler/Service)
+ */
+FString FProfilingService::GetDefaultSpoolDirectory()
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("BatchProfiler") / TEXT("Service"));
+}
+
+#pragma region Service Lifetime
+/**
+ * @brief Starts watching the spool directory for jobs
+ * @param InSpoolDirectory Directory containing Queue, Running, Done and Failed folders
+ */
+void FProfilingService::Start(const FString& InSpoolDirectory)
+{
+	Stop();
+
+	SpoolDirectory = InSpoolDirectory.IsEmpty() ? GetDefaultSpoolDirectory() : FPaths::ConvertRelativePathToFull(InSpoolDirectory);
+	for (const TCHAR* Folder : { ProfilingService::QueueFolder, ProfilingService::RunningFolder, ProfilingService::DoneFolder, ProfilingService::FailedFolder })
+	{
+		IFileManager::Get().MakeDirectory(*(SpoolDirectory / Folder), true);
+	}
+
+	// Jobs left in Running were interrupted by a crash or shutdown of a previous instance
+	TArray<FString> InterruptedJobs;
+	IFileManager::Get().FindFiles(InterruptedJobs, *(SpoolDirectory / ProfilingService::RunningFolder / TEXT("*.json")), true, false);
+	for (const FString& InterruptedJob : InterruptedJobs)
+	{
+		IFileManager::Get().Move(*GetJobPath(ProfilingService::FailedFolder, InterruptedJob), *GetJobPath(ProfilingService::RunningFolder, InterruptedJob));
+		UE_LOG(LogTemp, Warning, TEXT("Profiling job %s was interrupted, moved to Failed"), *InterruptedJob);
+	}
+
+	JobState = EJobState::Idle;
+	NextPollTime = 0.0;
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FProfilingService::Tick));
+
+	UE_LOG(LogTemp, Display, TEXT("Profiling service watching %s"), *SpoolDirectory);
+}
+
+/**
+ * @brief Stops watching the spool directory, a running job is cancelled and marked as failed
+ */
+void FProfilingService::Stop()
+{
+	if (!TickerHandle.IsValid())
+	{
+		return;
+	}
+
+	if (JobState == EJobState::Capturing)
+	{
+		ProfilerModule.CancelBatch();
+	}
+
+	if (JobState != EJobState::Idle)
+	{
+		FinishJob(false, TEXT("Service stopped"));
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+
+	UE_LOG(LogTemp, Display, TEXT("Profiling service stopped"));
+}
+
+bool FProfilingService::Tick(float DeltaTime)
+{
+	BATCHPROFILER_SCOPE(ServiceTick);
+	const double Now = FPlatformTime::Seconds();
+
+	switch (JobState)
+	{
+	case EJobState::Idle:
+		if (Now >= NextPollTime)
+		{
+			NextPollTime = Now + ProfilingService::PollIntervalSecs;
+			TryStartNextJob();
+		}
+		break;
+
+	case EJobState::LoadingMap:
+		if (Now > StateTimeout)
+		{
+			FinishJob(false, TEXT("Map load timed out"));
+		}
+		break;
+
+	case EJobState::WaitingForCameras:
+		// Cameras register on BeginPlay, which may happen a few frames after the map is loaded
+		if (ProfilerModule.GetBatchCameras().Num() > 0)
+		{
+			StartCapture();
+		}
+		else if (Now > StateTimeout)
+		{
+			FinishJob(false, TEXT("No matching ProfilingCameras found"));
+		}
+		break;
+
+	case EJobState::Capturing:
+		if (Now > StateTimeout)
+		{
+			ProfilerModule.CancelBatch();
+			FinishJob(false, TEXT("Capture timed out"));
+		}
+		break;
+	}
+
+	return true;
+}
+#pragma endregion
+
+#pragma region Jobs
+/**
+ * @brief Picks the oldest job from the queue and starts loading its map
+ */
+void FProfilingService::TryStartNextJob()
+{
+	if (FUtilities::GetGameWorld() == nullptr)
+	{
+		return;
+	}
+
+	TArray<FString> QueuedJobs;
+	IFileManager::Get().FindFiles(QueuedJobs, *(SpoolDirectory / ProfilingService::QueueFolder / TEXT("*.json")), true, false);
+	if (QueuedJobs.Num() == 0)
+	{
+		return;
+	}
+
+	QueuedJobs.Sort([this](const FString& A, const FString& B)
+	{
+		return IFileManager::Get().GetTimeStamp(*GetJobPath(ProfilingService::QueueFolder, A))
+			< IFileManager::Get().GetTimeStamp(*GetJobPath(ProfilingService::QueueFolder, B));
+	});
+
+	const FString JobFile = QueuedJobs[0];
+	const FString RunningPath = GetJobPath(ProfilingService::RunningFolder, JobFile);
+	if (!IFileManager::Get().Move(*RunningPath, *GetJobPath(ProfilingService::QueueFolder, JobFile)))
+	{
+		return;
+	}
+
+	ActiveJob = FProfilingJob();
+	ActiveJob.Name = FPaths::GetBaseFilename(JobFile);
+	ActiveJob.StartTime = FDateTime::UtcNow();
+	JobState = EJobState::LoadingMap;
+	UE_LOG(LogTemp, Display, TEXT("Starting profiling job %s"), *ActiveJob.Name);
+
+	FString Error;
+	if (!ParseJob(RunningPath, ActiveJob, Error))
+	{
+		FinishJob(false, Error);
+		return;
+	}
+
+	ApplySettingsOverrides(ActiveJob.Settings);
+	ProfilerModule.SetCameraFilter(ActiveJob.Cameras);
+
+	// Reuse the loaded map when possible, this is what makes the warm process cheap
+	if (ActiveJob.Map.IsEmpty() || FMapLoader::IsMapLoaded(ActiveJob.Map))
+	{
+		OnMapLoaded(FUtilities::GetGameWorld(), 0.0);
+		return;
+	}
+
+	StateTimeout = FPlatformTime::Seconds() + ProfilingService::MapLoadTimeoutSecs;
+	if (!MapLoader.LoadMap(ActiveJob.Map, FMapLoader::FOnMapLoaded::CreateRaw(this, &FProfilingService::OnMapLoaded)))
+	{
+		FinishJob(false, FString::Printf(TEXT("Could not load map %s"), *ActiveJob.Map));
+	}
+}
+
+/**
+ * @brief Reads a job file
+ * @param JobPath Path of the job json
+ * @param OutJob Parsed job
+ * @param OutError Error message if parsing fails
+ * @return If the job is valid
+ */
+bool FProfilingService::ParseJob(const FString& JobPath, FProfilingJob& OutJob, FString& OutError) const
+{
+	FString JobJson;
+	TSharedPtr<FJsonObject> JobObject;
+	if (!FFileHelper::LoadFileToString(JobJson, *JobPath) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JobJson), JobObject) || !JobObject.IsValid())
+	{
+		OutError = TEXT("Job is not valid json");
+		return false;
+	}
+
+	JobObject->TryGetStringField(TEXT("Map"), OutJob.Map);
+	JobObject->TryGetStringArrayField(TEXT("Cameras"), OutJob.Cameras);
+
+	double CaptureValue = 0.0;
+	if (JobObject->TryGetNumberField(TEXT("CaptureValue"), CaptureValue))
+	{
+		OutJob.CaptureValue = CaptureValue;
+	}
+
+	FString Backend;
+	if (JobObject->TryGetStringField(TEXT("Backend"), Backend))
+	{
+		const int64 BackendValue = StaticEnum<EProfilingCaptureBackend>()->GetValueByNameString(Backend);
+		if (BackendValue == INDEX_NONE)
+		{
+			OutError = FString::Printf(TEXT("Unknown capture backend %s"), *Backend);
+			return false;
+		}
+
+		OutJob.Backend = static_cast<EProfilingCaptureBackend>(BackendValue);
+	}
+
+	const TSharedPtr<FJsonObject>* SettingsObject = nullptr;
+	if (JobObject->TryGetObjectField(TEXT("Settings"), SettingsObject))
+	{
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Setting : (*SettingsObject)->Values)
+		{
+			FString Value;
+			if (!Setting.Value->TryGetString(Value))
+			{
+				OutError = FString::Printf(TEXT("Setting %s must be a string, number or bool"), *Setting.Key);
+				return false;
+			}
+
+			OutJob.Settings.Add(Setting.Key, Value);
+		}
+	}
+
+	return true;
+}
+
+void FProfilingService::OnMapLoaded(UWorld* World, const double LoadSecs)
+{
+	if (World == nullptr)
+	{
+		FinishJob(false, FString::Printf(TEXT("Could not load map %s"), *ActiveJob.Map));
+		return;
+	}
+
+	ActiveJob.MapLoadSecs = LoadSecs;
+	JobState = EJobState::WaitingForCameras;
+	StateTimeout = FPlatformTime::Seconds() + ProfilingService::CameraTimeoutSecs;
+}
+
+void FProfilingService::StartCapture()
+{
+	// Every camera may take its delay, capture and stall grace before the watchdog moves on
+	const UBatchProfilerSettings* BatchProfilerSettings = GetDefault<UBatchProfilerSettings>();
+	const bool bIsInsights = ActiveJob.Backend == EProfilingCaptureBackend::Trace || ActiveJob.Backend == EProfilingCaptureBackend::Snapshot;
+	const double CaptureSecs = bIsInsights ? (ActiveJob.CaptureValue > 0.f ? ActiveJob.CaptureValue : BatchProfilerSettings->TraceSettings.InsightsCaptureSeconds) : 1.0;
+	const double CameraSecs = BatchProfilerSettings->DelayBeforeEachCapture + CaptureSecs + BatchProfilerSettings->StalledCaptureGraceSeconds;
+	StateTimeout = FPlatformTime::Seconds() + ProfilerModule.GetBatchCameras().Num() * CameraSecs + ProfilingService::CaptureTimeoutMarginSecs;
+
+	JobState = EJobState::Capturing;
+	CaptureCompleteHandle = ProfilerModule.OnCaptureComplete().AddRaw(this, &FProfilingService::OnCaptureComplete);
+
+	if (!ProfilerModule.StartBatch(ActiveJob.Backend, ActiveJob.CaptureValue))
+	{
+		FinishJob(false, TEXT("Could not start batch"));
+	}
+}
+
+void FProfilingService::OnCaptureComplete()
+{
+	if (JobState == EJobState::Capturing)
+	{
+		FinishJob(true, FString());
+	}
+}
+
+/**
+ * @brief Writes the job result, moves the job to Done or Failed and restores the service state
+ * @param bSuccess If the job succeeded
+ * @param Error Error message of a failed job
+ */
+void FProfilingService::FinishJob(const bool bSuccess, const FString& Error)
+{
+	ProfilerModule.OnCaptureComplete().Remove(CaptureCompleteHandle);
+	CaptureCompleteHandle.Reset();
+	ProfilerModule.SetCameraFilter(TArray<FString>());
+	RestoreSettings();
+
+	// Everything written to the profiling directory since the job started belongs to it
+	TArray<FString> ProfilingFiles;
+	TArray<TSharedPtr<FJsonValue>> Outputs;
+	IFileManager::Get().FindFilesRecursive(ProfilingFiles, *FPaths::ConvertRelativePathToFull(FPaths::ProfilingDir()), TEXT("*.*"), true, false);
+	for (const FString& ProfilingFile : ProfilingFiles)
+	{
+		if (IFileManager::Get().GetTimeStamp(*ProfilingFile) >= ActiveJob.StartTime)
+		{
+			Outputs.Add(MakeShared<FJsonValueString>(ProfilingFile));
+		}
+	}
+
+	const TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	Result->SetStringField(TEXT("Job"), ActiveJob.Name);
+	Result->SetStringField(TEXT("Status"), bSuccess ? TEXT("Succeeded") : TEXT("Failed"));
+	Result->SetStringField(TEXT("Error"), Error);
+	Result->SetStringField(TEXT("Map"), ActiveJob.Map);
+	Result->SetNumberField(TEXT("MapLoadSeconds"), ActiveJob.MapLoadSecs);
+	Result->SetNumberField(TEXT("DurationSeconds"), (FDateTime::UtcNow() - ActiveJob.StartTime).GetTotalSeconds());
+	Result->SetArrayField(TEXT("Outputs"), Outputs);
+
+	FString ResultJson;
+	FJsonSerializer::Serialize(Result, TJsonWriterFactory<>::Create(&ResultJson));
+
+	const TCHAR* TargetFolder = bSuccess ? ProfilingService::DoneFolder : ProfilingService::FailedFolder;
+	FFileHelper::SaveStringToFile(ResultJson, *GetJobPath(TargetFolder, ActiveJob.Name + TEXT(".result.json")));
+	IFileManager::Get().Move(*GetJobPath(TargetFolder, ActiveJob.Name + TEXT(".json")), *GetJobPath(ProfilingService::RunningFolder, ActiveJob.Name + TEXT(".json")));
+
+	if (bSuccess)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Profiling job %s succeeded"), *ActiveJob.Name);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Profiling job %s failed: %s"), *ActiveJob.Name, *Error);
+	}
+
+	JobState = EJobState::Idle;
+}
+
+FString FProfilingService::GetJobPath(const TCHAR* Folder, const FString& FileName) const
+{
+	return SpoolDirectory / Folder / FileName;
+}
+#pragma endregion
+
+#pragma region Settings Overrides
+/**
+ * @brief Overrides batch profiler settings for the duration of a job
+ * @param Settings Property name and value in text export format
+ */
+void FProfilingService::ApplySettingsOverrides(const TMap<FString, FString>& Settings)
+{
+	UBatchProfilerSettings* BatchProfilerSettings = GetMutableDefault<UBatchProfilerSettings>();
+
+	for (const TPair<FString, FString>& Setting : Settings)
+	{
+		FProperty* Property = FindFProperty<FProperty>(UBatchProfilerSettings::StaticClass(), *Setting.Key);
+		if (Property == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Unknown batch profiler setting %s"), *Setting.Key);
+			continue;
+		}
+
+		FString OriginalValue;
+		// Without a default container struct and array values are exported in full instead of as an empty delta
+		Property->ExportText_InContainer(0, OriginalValue, BatchProfilerSettings, nullptr, BatchProfilerSettings, PPF_None);
+		OriginalSettings.Emplace(Property, OriginalValue);
+
+		Property->ImportText_InContainer(*Setting.Value, BatchProfilerSettings, BatchProfilerSettings, PPF_None);
+	}
+}
+
+void FProfilingService::RestoreSettings()
+{
+	UBatchProfilerSettings* BatchProfilerSettings = GetMutableDefault<UBatchProfilerSettings>();
+
+	// Restore in reverse order in case a setting is overridden twice
+	for (int32 Index = OriginalSettings.Num() - 1; Index >= 0; --Index)
+	{
+		OriginalSettings[Index].Key->ImportText_InContainer(*OriginalSettings[Index].Value, BatchProfilerSettings, BatchProfilerSettings, PPF_None);
+	}
+
+	OriginalSettings.Reset();
+}
+#pragma endregion
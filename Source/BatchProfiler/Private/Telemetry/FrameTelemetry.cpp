@@ -0,0 +1,195 @@
+#include "Telemetry/FrameTelemetry.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Utilities/Utilities.h"
+
+#pragma region Format
+const TCHAR* FrameTelemetryFormat::GetColumnName(const EFrameTelemetryColumn Column)
+{
+	switch (Column)
+	{
+	case EFrameTelemetryColumn::FrameMs: return TEXT("FrameMs");
+	case EFrameTelemetryColumn::GameThreadMs: return TEXT("GameThreadMs");
+	case EFrameTelemetryColumn::RenderThreadMs: return TEXT("RenderThreadMs");
+	case EFrameTelemetryColumn::RHIThreadMs: return TEXT("RHIThreadMs");
+	case EFrameTelemetryColumn::GPUMs: return TEXT("GPUMs");
+	case EFrameTelemetryColumn::UsedPhysicalMB: return TEXT("UsedPhysicalMB");
+	case EFrameTelemetryColumn::DrawCalls: return TEXT("DrawCalls");
+	case EFrameTelemetryColumn::PrimitivesDrawn: return TEXT("PrimitivesDrawn");
+	default: return TEXT("Unknown");
+	}
+}
+
+FString FrameTelemetryFormat::GetTelemetryDirectory()
+{
+	return FUtilities::GetReportDirectory() / TEXT("Telemetry");
+}
+#pragma endregion
+
+#pragma region Reader
+FFrameTelemetryReader::~FFrameTelemetryReader()
+{
+	Close();
+}
+
+/**
+ * @brief Maps a telemetry file and reads its regions from the index, or from the region headers if the batch was interrupted
+ * @param Filename Telemetry file
+ * @return If the file is a valid telemetry file
+ */
+bool FFrameTelemetryReader::Open(const FString& Filename)
+{
+	Close();
+
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (!MappedFile.IsValid() || MappedFile->GetFileSize() < static_cast<int64>(sizeof(FrameTelemetryFormat::FHeader)))
+	{
+		Close();
+		return false;
+	}
+
+	MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	if (!MappedRegion.IsValid())
+	{
+		Close();
+		return false;
+	}
+
+	const uint8* Data = MappedRegion->GetMappedPtr();
+	const uint64 Size = MappedRegion->GetMappedSize();
+
+	FrameTelemetryFormat::FHeader Header;
+	FMemory::Memcpy(&Header, Data, sizeof(Header));
+	if (Header.Magic != FrameTelemetryFormat::HeaderMagic || Header.Version > FrameTelemetryFormat::Version)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s is not a supported frame telemetry file"), *Filename);
+		Close();
+		return false;
+	}
+
+	BatchStartTicks = Header.BatchStartTicks;
+	bIsComplete = ReadIndex(Data, Size, Header.ColumnCount);
+	if (!bIsComplete)
+	{
+		Regions.Reset();
+		ScanRegions(Data, Size, Header.ColumnCount);
+	}
+
+	return true;
+}
+
+void FFrameTelemetryReader::Close()
+{
+	Regions.Reset();
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	BatchStartTicks = 0;
+	bIsComplete = false;
+}
+
+bool FFrameTelemetryReader::ReadIndex(const uint8* Data, const uint64 Size, const uint16 ColumnCount)
+{
+	if (Size < sizeof(FrameTelemetryFormat::FHeader) + sizeof(FrameTelemetryFormat::FFooter))
+	{
+		return false;
+	}
+
+	FrameTelemetryFormat::FFooter Footer;
+	FMemory::Memcpy(&Footer, Data + Size - sizeof(Footer), sizeof(Footer));
+	if (Footer.Magic != FrameTelemetryFormat::FooterMagic || Footer.IndexOffset > Size - sizeof(Footer))
+	{
+		return false;
+	}
+
+	uint64 Offset = Footer.IndexOffset;
+	const uint64 IndexEnd = Size - sizeof(Footer);
+	for (uint32 RegionIndex = 0; RegionIndex < Footer.RegionCount; ++RegionIndex)
+	{
+		FrameTelemetryFormat::FIndexEntry Entry;
+		if (Offset + sizeof(Entry) > IndexEnd)
+		{
+			return false;
+		}
+		FMemory::Memcpy(&Entry, Data + Offset, sizeof(Entry));
+		Offset += sizeof(Entry);
+
+		if (Offset + Entry.NameLength > IndexEnd)
+		{
+			return false;
+		}
+		const FUTF8ToTCHAR ConvertedName(reinterpret_cast<const ANSICHAR*>(Data + Offset), Entry.NameLength);
+		const FString CameraName(ConvertedName.Length(), ConvertedName.Get());
+		Offset += Align(Entry.NameLength, 4);
+
+		if (!AddRegion(Data, Size, Entry.RegionOffset, ColumnCount, CameraName))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Walks the region headers of a file without index, camera names are read from the region headers
+ */
+bool FFrameTelemetryReader::ScanRegions(const uint8* Data, const uint64 Size, const uint16 ColumnCount)
+{
+	uint64 Offset = sizeof(FrameTelemetryFormat::FHeader);
+	while (Offset + sizeof(FrameTelemetryFormat::FRegionHeader) <= Size)
+	{
+		if (!AddRegion(Data, Size, Offset, ColumnCount, FString()))
+		{
+			break;
+		}
+
+		FrameTelemetryFormat::FRegionHeader RegionHeader;
+		FMemory::Memcpy(&RegionHeader, Data + Offset, sizeof(RegionHeader));
+		Offset += FrameTelemetryFormat::GetRegionSize(RegionHeader.FrameCount, ColumnCount, RegionHeader.NameLength);
+	}
+
+	return Regions.Num() > 0;
+}
+
+bool FFrameTelemetryReader::AddRegion(const uint8* Data, const uint64 Size, const uint64 Offset, const uint16 ColumnCount, const FString& CameraName)
+{
+	if (Offset + sizeof(FrameTelemetryFormat::FRegionHeader) > Size || Offset % 4 != 0)
+	{
+		return false;
+	}
+
+	FrameTelemetryFormat::FRegionHeader RegionHeader;
+	FMemory::Memcpy(&RegionHeader, Data + Offset, sizeof(RegionHeader));
+	if (RegionHeader.Magic != FrameTelemetryFormat::RegionMagic
+		|| Offset + FrameTelemetryFormat::GetRegionSize(RegionHeader.FrameCount, ColumnCount, RegionHeader.NameLength) > Size)
+	{
+		return false;
+	}
+
+	// Version 1 regions have no name, their name is only known from the index
+	const uint8* RegionName = Data + Offset + sizeof(RegionHeader);
+	FString Name = CameraName;
+	if (Name.IsEmpty() && RegionHeader.NameLength > 0)
+	{
+		const FUTF8ToTCHAR ConvertedName(reinterpret_cast<const ANSICHAR*>(RegionName), RegionHeader.NameLength);
+		Name = FString(ConvertedName.Length(), ConvertedName.Get());
+	}
+
+	FFrameTelemetryRegion& Region = Regions.AddDefaulted_GetRef();
+	Region.CameraId = RegionHeader.CameraId;
+	Region.CameraName = Name.IsEmpty() ? FString::Printf(TEXT("Camera%u"), RegionHeader.CameraId) : Name;
+	Region.FrameCount = RegionHeader.FrameCount;
+
+	// Columns are 4 byte aligned inside the page aligned mapping, they are used in place
+	const uint8* Column = RegionName + Align(RegionHeader.NameLength, 4);
+	Region.FrameNumbers = reinterpret_cast<const uint32*>(Column);
+	const int32 KnownColumns = FMath::Min<int32>(ColumnCount, static_cast<int32>(EFrameTelemetryColumn::Count));
+	for (int32 ColumnIndex = 0; ColumnIndex < KnownColumns; ++ColumnIndex)
+	{
+		Column += static_cast<uint64>(RegionHeader.FrameCount) * sizeof(uint32);
+		Region.Columns.Add(reinterpret_cast<const float*>(Column));
+	}
+
+	return true;
+}
+#pragma endregion
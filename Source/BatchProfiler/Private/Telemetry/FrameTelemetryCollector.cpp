@@ -0,0 +1,227 @@
+#include "Telemetry/FrameTelemetryCollector.h"
+#include "Utilities/ProfilerStats.h"
+#include "BatchProfilerSettings.h"
+#include "CoreGlobals.h"
+#include "HAL/PlatformFileManager.h"
+#include "RenderCore.h"
+#include "RHI.h"
+
+namespace FrameTelemetryCollector
+{
+	static constexpr double MemorySampleIntervalSecs = 0.25;
+
+	// Camera names are padded so columns stay 4 byte aligned
+	static constexpr uint8 Padding[4] = {};
+}
+
+FFrameTelemetryCollector::~FFrameTelemetryCollector()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	}
+
+	CloseFile();
+}
+
+void FFrameTelemetryCollector::BeginBatch()
+{
+	CloseFile();
+	WrittenRegions.Reset();
+}
+
+#pragma region Capture Window
+/**
+ * @brief Starts sampling a row every frame, the file is created with the first window of the batch
+ * @param Camera Camera being captured
+ */
+void FFrameTelemetryCollector::BeginCapture(const AProfilingCamera* Camera)
+{
+	BATCHPROFILER_SCOPE(FrameTelemetryBeginCapture);
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	if (!GetDefault<UBatchProfilerSettings>()->WriteFrameTelemetry || (!FileHandle.IsValid() && !OpenFile()))
+	{
+		return;
+	}
+
+	FrameNumbers.Reset();
+	for (TArray<float>& Column : Columns)
+	{
+		Column.Reset();
+	}
+	NextMemorySampleTime = 0.0;
+
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FFrameTelemetryCollector::Tick));
+}
+
+/**
+ * @brief Appends the frames of the window as a region of the telemetry file
+ * @param Summary Summary of the camera
+ */
+void FFrameTelemetryCollector::EndCapture(FCameraCaptureSummary& Summary)
+{
+	BATCHPROFILER_SCOPE(FrameTelemetryEndCapture);
+	if (!TickerHandle.IsValid())
+	{
+		return;
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+
+	// Windows of failed cameras are discarded with an unnamed summary
+	if (!Summary.CameraName.IsEmpty())
+	{
+		WriteRegion(Summary.CameraName);
+	}
+}
+
+bool FFrameTelemetryCollector::Tick(const float DeltaTime)
+{
+	BATCHPROFILER_SCOPE(FrameTelemetryTick);
+	const double Now = FPlatformTime::Seconds();
+	if (Now >= NextMemorySampleTime)
+	{
+		UsedPhysicalMB = FPlatformMemory::GetStats().UsedPhysical / (1024.f * 1024.f);
+		NextMemorySampleTime = Now + FrameTelemetryCollector::MemorySampleIntervalSecs;
+	}
+
+	FrameNumbers.Add(static_cast<uint32>(GFrameCounter));
+	Columns[static_cast<int32>(EFrameTelemetryColumn::FrameMs)].Add(DeltaTime * 1000.f);
+	Columns[static_cast<int32>(EFrameTelemetryColumn::GameThreadMs)].Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+	Columns[static_cast<int32>(EFrameTelemetryColumn::RenderThreadMs)].Add(FPlatformTime::ToMilliseconds(GRenderThreadTime));
+	Columns[static_cast<int32>(EFrameTelemetryColumn::RHIThreadMs)].Add(FPlatformTime::ToMilliseconds(GRHIThreadTime));
+	Columns[static_cast<int32>(EFrameTelemetryColumn::GPUMs)].Add(FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles()));
+	Columns[static_cast<int32>(EFrameTelemetryColumn::UsedPhysicalMB)].Add(UsedPhysicalMB);
+	Columns[static_cast<int32>(EFrameTelemetryColumn::DrawCalls)].Add(GNumDrawCallsRHI[0]);
+	Columns[static_cast<int32>(EFrameTelemetryColumn::PrimitivesDrawn)].Add(GNumPrimitivesDrawnRHI[0]);
+	return true;
+}
+#pragma endregion
+
+#pragma region File
+bool FFrameTelemetryCollector::OpenFile()
+{
+	const FString Directory = FrameTelemetryFormat::GetTelemetryDirectory();
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*Directory);
+
+	const FDateTime Now = FDateTime::Now();
+	Filename = Directory / FString::Printf(TEXT("FrameTelemetry_%s%s"), *Now.ToString(TEXT("%Y.%m.%d_%H.%M.%S")), FrameTelemetryFormat::Extension);
+	FileHandle.Reset(PlatformFile.OpenWrite(*Filename));
+	if (!FileHandle.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could Not Create Frame Telemetry: %s"), *Filename);
+		return false;
+	}
+
+	FrameTelemetryFormat::FHeader Header;
+	Header.BatchStartTicks = Now.GetTicks();
+	return Write(&Header, sizeof(Header));
+}
+
+/**
+ * @brief Appends the region of a camera and flushes it, so interrupted batches keep every finished camera
+ * @param CameraName Name of the captured camera
+ */
+void FFrameTelemetryCollector::WriteRegion(const FString& CameraName)
+{
+	if (!FileHandle.IsValid() || FrameNumbers.Num() == 0)
+	{
+		return;
+	}
+
+	FRegionEntry& Entry = WrittenRegions.AddDefaulted_GetRef();
+	Entry.CameraName = CameraName;
+	Entry.FrameCount = FrameNumbers.Num();
+	Entry.RegionOffset = FileHandle->Tell();
+
+	// The name is kept with the region so files of interrupted batches can still be filtered by camera
+	const FTCHARToUTF8 RegionName(*CameraName);
+
+	FrameTelemetryFormat::FRegionHeader RegionHeader;
+	RegionHeader.CameraId = WrittenRegions.Num() - 1;
+	RegionHeader.FrameCount = Entry.FrameCount;
+	RegionHeader.NameLength = RegionName.Length();
+
+	bool bSuccess = Write(&RegionHeader, sizeof(RegionHeader));
+	bSuccess &= Write(RegionName.Get(), RegionName.Length());
+	bSuccess &= Write(FrameTelemetryCollector::Padding, Align(RegionName.Length(), 4) - RegionName.Length());
+	bSuccess &= Write(FrameNumbers.GetData(), FrameNumbers.Num() * sizeof(uint32));
+	for (const TArray<float>& Column : Columns)
+	{
+		bSuccess &= Write(Column.GetData(), Column.Num() * sizeof(float));
+	}
+
+	if (!bSuccess)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could Not Write Frame Telemetry: %s"), *Filename);
+		WrittenRegions.Pop();
+		CloseFile();
+		return;
+	}
+
+	FileHandle->Flush();
+}
+
+bool FFrameTelemetryCollector::Write(const void* Data, const int64 Size)
+{
+	return Size == 0 || FileHandle->Write(static_cast<const uint8*>(Data), Size);
+}
+
+void FFrameTelemetryCollector::CloseFile()
+{
+	FileHandle.Reset();
+}
+#pragma endregion
+
+#pragma region Report
+/**
+ * @brief Appends the index of camera regions and the footer, then closes the telemetry file
+ */
+void FFrameTelemetryCollector::CompleteBatch(const TArray<FCameraCaptureSummary>& Summaries)
+{
+	if (!FileHandle.IsValid())
+	{
+		return;
+	}
+
+	FrameTelemetryFormat::FFooter Footer;
+	Footer.IndexOffset = FileHandle->Tell();
+	Footer.RegionCount = WrittenRegions.Num();
+
+	bool bSuccess = true;
+	for (int32 RegionIndex = 0; RegionIndex < WrittenRegions.Num(); ++RegionIndex)
+	{
+		const FRegionEntry& Region = WrittenRegions[RegionIndex];
+		const FTCHARToUTF8 CameraName(*Region.CameraName);
+
+		FrameTelemetryFormat::FIndexEntry Entry;
+		Entry.CameraId = RegionIndex;
+		Entry.FrameCount = Region.FrameCount;
+		Entry.RegionOffset = Region.RegionOffset;
+		Entry.NameLength = CameraName.Length();
+
+		bSuccess &= Write(&Entry, sizeof(Entry));
+		bSuccess &= Write(CameraName.Get(), CameraName.Length());
+		bSuccess &= Write(FrameTelemetryCollector::Padding, Align(CameraName.Length(), 4) - CameraName.Length());
+	}
+	bSuccess &= Write(&Footer, sizeof(Footer));
+
+	if (bSuccess)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Saved Frame Telemetry: %s"), *Filename);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could Not Write Frame Telemetry Index: %s"), *Filename);
+	}
+
+	CloseFile();
+}
+#pragma endregion
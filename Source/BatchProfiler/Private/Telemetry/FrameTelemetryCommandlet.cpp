@@ -0,0 +1,124 @@
+#include "Telemetry/FrameTelemetryCommandlet.h"
+#include "HAL/FileManager.h"
+#include "Telemetry/FrameTelemetry.h"
+#include "Utilities/Utilities.h"
+
+UFrameTelemetryCommandlet::UFrameTelemetryCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UFrameTelemetryCommandlet::Main(const FString& Params)
+{
+	FString Directory = FrameTelemetryFormat::GetTelemetryDirectory();
+	FParse::Value(*Params, TEXT("Dir="), Directory);
+
+	FString CameraFilter;
+	FParse::Value(*Params, TEXT("Camera="), CameraFilter);
+
+	FDateTime Since = FDateTime::MinValue();
+	FString SinceString;
+	if (FParse::Value(*Params, TEXT("Since="), SinceString))
+	{
+		TArray<FString> DateParts;
+		SinceString.ParseIntoArray(DateParts, TEXT("."));
+		if (DateParts.Num() != 3 || !FDateTime::Validate(FCString::Atoi(*DateParts[0]), FCString::Atoi(*DateParts[1]), FCString::Atoi(*DateParts[2]), 0, 0, 0, 0))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Since must be YYYY.MM.DD: %s"), *SinceString);
+			return 1;
+		}
+		Since = FDateTime(FCString::Atoi(*DateParts[0]), FCString::Atoi(*DateParts[1]), FCString::Atoi(*DateParts[2]));
+	}
+
+	EFrameTelemetryColumn Column = EFrameTelemetryColumn::FrameMs;
+	FString ColumnName;
+	if (FParse::Value(*Params, TEXT("Column="), ColumnName))
+	{
+		bool bFound = false;
+		for (int32 ColumnIndex = 0; ColumnIndex < static_cast<int32>(EFrameTelemetryColumn::Count); ++ColumnIndex)
+		{
+			if (ColumnName.Equals(FrameTelemetryFormat::GetColumnName(static_cast<EFrameTelemetryColumn>(ColumnIndex)), ESearchCase::IgnoreCase))
+			{
+				Column = static_cast<EFrameTelemetryColumn>(ColumnIndex);
+				bFound = true;
+			}
+		}
+
+		if (!bFound)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Unknown telemetry column: %s"), *ColumnName);
+			return 1;
+		}
+	}
+
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(Directory / TEXT("*") + FrameTelemetryFormat::Extension), true, false);
+	Files.Sort();
+
+	const double StartTime = FPlatformTime::Seconds();
+	const TCHAR* ColumnLabel = FrameTelemetryFormat::GetColumnName(Column);
+	FString Report = FString::Printf(TEXT("File,BatchStart,Complete,Camera,Frames,Avg%s,P95%s,Max%s\n"), ColumnLabel, ColumnLabel, ColumnLabel);
+	int64 ScannedFrames = 0;
+	int32 ScannedFiles = 0;
+	TArray<float> SortedValues;
+
+	for (const FString& File : Files)
+	{
+		FFrameTelemetryReader Reader;
+		if (!Reader.Open(Directory / File))
+		{
+			continue;
+		}
+
+		if (Reader.GetBatchStartTime() < Since)
+		{
+			continue;
+		}
+
+		ScannedFiles++;
+		for (const FFrameTelemetryRegion& Region : Reader.GetRegions())
+		{
+			if (!CameraFilter.IsEmpty() && !Region.CameraName.Equals(CameraFilter, ESearchCase::IgnoreCase))
+			{
+				continue;
+			}
+
+			const TArrayView<const float> Values = Region.GetColumn(Column);
+			if (Values.Num() == 0)
+			{
+				continue;
+			}
+
+			double Sum = 0.0;
+			float Max = Values[0];
+			for (const float Value : Values)
+			{
+				Sum += Value;
+				Max = FMath::Max(Max, Value);
+			}
+
+			SortedValues = Values;
+			SortedValues.Sort();
+			const int32 P95Index = FMath::Clamp(FMath::CeilToInt(0.95f * Values.Num()) - 1, 0, Values.Num() - 1);
+
+			Report += FString::Printf(TEXT("%s,%s,%s,%s,%d,%.3f,%.3f,%.3f\n"),
+				*File,
+				*Reader.GetBatchStartTime().ToString(TEXT("%Y.%m.%d %H:%M:%S")),
+				Reader.IsComplete() ? TEXT("Yes") : TEXT("No"),
+				*Region.CameraName,
+				Values.Num(),
+				Sum / Values.Num(),
+				SortedValues[P95Index],
+				Max);
+			ScannedFrames += Values.Num();
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Scanned %lld frames in %d telemetry files in %.2f seconds"), ScannedFrames, ScannedFiles, FPlatformTime::Seconds() - StartTime);
+
+	const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y.%m.%d_%H.%M"));
+	return FUtilities::SaveReport(FString::Printf(TEXT("TelemetryScan_%s.csv"), *Timestamp), Report) ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#include "Utilities/MapLoader.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/PackageName.h"
+#include "UObject/UObjectGlobals.h"
+#include "Utilities/Utilities.h"
+
+FMapLoader::~FMapLoader()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	if (GEngine)
+	{
+		GEngine->OnTravelFailure().Remove(TravelFailureHandle);
+	}
+}
+
+/**
+ * @brief Opens a map and calls back once it is loaded
+ * @param MapName Long (/Game/Maps/Map) or short (Map) map name
+ * @param InOnLoaded Called with the loaded world and load time
+ * @return If loading is started
+ */
+bool FMapLoader::LoadMap(const FString& MapName, const FOnMapLoaded& InOnLoaded)
+{
+	UWorld* World = FUtilities::GetGameWorld();
+	if (World == nullptr || IsLoading())
+	{
+		return false;
+	}
+
+	PendingMapName = MapName;
+	OnLoaded = InOnLoaded;
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FMapLoader::OnPostLoadMap);
+	TravelFailureHandle = GEngine->OnTravelFailure().AddRaw(this, &FMapLoader::OnTravelFailure);
+
+	UE_LOG(LogTemp, Display, TEXT("Loading Map: %s"), *MapName);
+	StartTime = FPlatformTime::Seconds();
+	UGameplayStatics::OpenLevel(World, FName(*MapName));
+
+	return true;
+}
+
+/**
+ * @brief Checks if the game world is the given map
+ * @param MapName Long (/Game/Maps/Map) or short (Map) map name
+ */
+bool FMapLoader::IsMapLoaded(const FString& MapName)
+{
+	const UWorld* World = FUtilities::GetGameWorld();
+	if (World == nullptr)
+	{
+		return false;
+	}
+
+	const FString LoadedMap = UWorld::RemovePIEPrefix(World->GetOutermost()->GetName());
+	return LoadedMap.Equals(MapName, ESearchCase::IgnoreCase)
+		|| FPackageName::GetShortName(LoadedMap).Equals(FPackageName::GetShortName(MapName), ESearchCase::IgnoreCase);
+}
+
+void FMapLoader::OnPostLoadMap(UWorld* World)
+{
+	if (World && IsMapLoaded(PendingMapName))
+	{
+		Finish(World);
+	}
+}
+
+void FMapLoader::OnTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& Error)
+{
+	UE_LOG(LogTemp, Error, TEXT("Could Not Load Map %s: %s"), *PendingMapName, *Error);
+	Finish(nullptr);
+}
+
+void FMapLoader::Finish(UWorld* World)
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	GEngine->OnTravelFailure().Remove(TravelFailureHandle);
+	PostLoadMapHandle.Reset();
+	TravelFailureHandle.Reset();
+
+	const double LoadSecs = FPlatformTime::Seconds() - StartTime;
+	if (World)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Loaded Map %s in %.2f seconds"), *PendingMapName, LoadSecs);
+	}
+
+	// Copy the delegate, the callback may start loading the next map
+	const FOnMapLoaded Callback = OnLoaded;
+	OnLoaded.Unbind();
+	Callback.ExecuteIfBound(World, LoadSecs);
+}
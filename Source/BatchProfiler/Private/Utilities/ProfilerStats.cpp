@@ -0,0 +1,34 @@
+#include "Utilities/ProfilerStats.h"
+#include <atomic>
+
+namespace ProfilerOverhead
+{
+	static std::atomic<uint64> TotalCycles { 0 };
+	static thread_local int32 ScopeDepth = 0;
+}
+
+FProfilerOverhead::FScope::FScope()
+	: StartCycles(ProfilerOverhead::ScopeDepth++ == 0 ? FPlatformTime::Cycles64() : 0)
+{
+}
+
+FProfilerOverhead::FScope::~FScope()
+{
+	if (--ProfilerOverhead::ScopeDepth == 0)
+	{
+		ProfilerOverhead::TotalCycles.fetch_add(FPlatformTime::Cycles64() - StartCycles, std::memory_order_relaxed);
+	}
+}
+
+/**
+ * @brief Seconds spent in plugin scopes on every thread since the last reset
+ */
+double FProfilerOverhead::GetSeconds()
+{
+	return FPlatformTime::ToSeconds64(ProfilerOverhead::TotalCycles.load(std::memory_order_relaxed));
+}
+
+void FProfilerOverhead::Reset()
+{
+	ProfilerOverhead::TotalCycles.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,90 @@
+#include "Utilities/TraceChannels.h"
+#include "Trace/Trace.h"
+
+/**
+ * @brief Returns the engine identifier of a trace channel (as used by trace.file and trace.enable)
+ * @param Channel Profiling trace channel
+ * @return Channel identifier registered by the engine
+ */
+FString FTraceChannels::GetChannelName(const EProfilingTraceChannel Channel)
+{
+	switch (Channel)
+	{
+	case EProfilingTraceChannel::MemAlloc:				return TEXT("MemAlloc");
+	case EProfilingTraceChannel::MemTag:				return TEXT("MemTag");
+	case EProfilingTraceChannel::VisualLogger:			return TEXT("VisualLogger");
+	case EProfilingTraceChannel::Physics:				return TEXT("Physics");
+	case EProfilingTraceChannel::Animation:				return TEXT("Animation");
+	case EProfilingTraceChannel::Object:				return TEXT("Object");
+	case EProfilingTraceChannel::ObjectProperties:		return TEXT("ObjectProperties");
+	case EProfilingTraceChannel::NetworkPrediction:		return TEXT("NetworkPrediction");
+	case EProfilingTraceChannel::RDG:					return TEXT("RDG");
+	case EProfilingTraceChannel::Slate:					return TEXT("Slate");
+	case EProfilingTraceChannel::Niagara:				return TEXT("Niagara");
+	case EProfilingTraceChannel::Messaging:				return TEXT("Messaging");
+	case EProfilingTraceChannel::TraceSourceFilters:	return TEXT("TraceSourceFilters");
+	case EProfilingTraceChannel::PoseSearch:			return TEXT("PoseSearch");
+	case EProfilingTraceChannel::Concert:				return TEXT("Concert");
+	case EProfilingTraceChannel::LevelSnapshots:		return TEXT("LevelSnapshots");
+	default:											return FString();
+	}
+}
+
+/**
+ * @brief Lists every trace channel currently registered by the engine and loaded modules
+ * @return Channel identifiers
+ */
+TArray<FString> FTraceChannels::GetRegisteredChannels()
+{
+	TArray<FString> Channels;
+	UE::Trace::EnumerateChannels([](const UE::Trace::FChannelInfo& Info, void* User)
+	{
+		static_cast<TArray<FString>*>(User)->Add(ANSI_TO_TCHAR(Info.Name));
+		return true;
+	}, &Channels);
+
+	return Channels;
+}
+
+/**
+ * @brief Checks if a trace channel is registered by the engine
+ * @param ChannelName Channel identifier
+ * @return True if the channel can be enabled
+ */
+bool FTraceChannels::IsChannelRegistered(const FString& ChannelName)
+{
+	return GetRegisteredChannels().ContainsByPredicate([&ChannelName](const FString& Registered)
+	{
+		return Registered.Equals(ChannelName, ESearchCase::IgnoreCase);
+	});
+}
+
+/**
+ * @brief Builds a comma separated channel set for trace.file, skipping channels the engine does not know
+ * @param Channels Channels to enable on top of the default set
+ * @return Channel set (always starts with the default channels)
+ */
+FString FTraceChannels::BuildChannelSet(const TArray<EProfilingTraceChannel>& Channels)
+{
+	const TArray<FString> RegisteredChannels = GetRegisteredChannels();
+
+	FString ChannelSet = TEXT("default");
+	for (const EProfilingTraceChannel Channel : Channels)
+	{
+		const FString ChannelName = GetChannelName(Channel);
+		const bool bIsRegistered = RegisteredChannels.ContainsByPredicate([&ChannelName](const FString& Registered)
+		{
+			return Registered.Equals(ChannelName, ESearchCase::IgnoreCase);
+		});
+
+		if (!bIsRegistered)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Trace channel %s is not registered, skipping"), *ChannelName);
+			continue;
+		}
+
+		ChannelSet += TEXT(",") + ChannelName;
+	}
+
+	return ChannelSet;
+}
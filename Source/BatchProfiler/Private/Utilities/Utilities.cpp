@@ -1,6 +1,10 @@
 #include "Utilities/Utilities.h"
+#include "Utilities/ProfilerStats.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "Widgets/Notifications/SNotificationList.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Engine/Engine.h"
 
 /**
  * @brief Executes a console command
@@ -8,16 +12,17 @@
  */
 void FUtilities::ExecuteCommand(const FString Cmd)
 {
+	BATCHPROFILER_SCOPE(ExecuteCommand);
 	const bool bSuccess = GEngine->Exec(nullptr, *Cmd, *GLog);
-	// const bool bSuccess = true;
 	
+	// Commands run inside measured windows, only failures are logged by default
 	if (bSuccess)
 	{
-		UE_LOG(LogTemp, Display, TEXT("Executed Command: %s"), *Cmd);
+		UE_LOG(LogTemp, Verbose, TEXT("Executed Command: %s"), *Cmd);
 	}
 	else
 	{
-		UE_LOG(LogTemp, Display, TEXT("Could Not Execute Command: %s"), *Cmd);
+		UE_LOG(LogTemp, Warning, TEXT("Could Not Execute Command: %s"), *Cmd);
 	}
 }
 
@@ -29,6 +34,7 @@ void FUtilities::ExecuteCommand(const FString Cmd)
  */
 void FUtilities::ShowNotification(const FString& Message, const bool bIsSuccess, const float FadeOutDuration)
 {
+	BATCHPROFILER_SCOPE(ShowNotification);
 	FNotificationInfo NotifyInfo(FText::FromString(Message));
 	NotifyInfo.bUseLargeFont = true;
 	NotifyInfo.FadeOutDuration = FadeOutDuration;
@@ -44,3 +50,53 @@ void FUtilities::ShowNotification(const FString& Message, const bool bIsSuccess,
 
 	FSlateNotificationManager::Get().AddNotification(NotifyInfo);
 }
+
+/**
+ * @brief Returns the directory batch profiler reports are written to
+ * @return Absolute path of the report directory
+ */
+FString FUtilities::GetReportDirectory()
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProfilingDir() / TEXT("BatchProfiler"));
+}
+
+/**
+ * @brief Saves a report into the report directory
+ * @param ReportName File name of the report (ie. TraceCalibration.csv)
+ * @param Contents Report contents
+ * @return If the report is successfully saved
+ */
+bool FUtilities::SaveReport(const FString& ReportName, const FString& Contents)
+{
+	BATCHPROFILER_SCOPE(SaveReport);
+	const FString ReportPath = GetReportDirectory() / ReportName;
+	const bool bSuccess = FFileHelper::SaveStringToFile(Contents, *ReportPath);
+
+	if (bSuccess)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Saved Report: %s"), *ReportPath);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could Not Save Report: %s"), *ReportPath);
+	}
+
+	return bSuccess;
+}
+
+/**
+ * @brief Returns the world of the running game or play in editor session
+ * @return Game world or null if nothing is playing
+ */
+UWorld* FUtilities::GetGameWorld()
+{
+	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+	{
+		if ((WorldContext.WorldType == EWorldType::Game || WorldContext.WorldType == EWorldType::PIE) && WorldContext.World())
+		{
+			return WorldContext.World();
+		}
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AProfilingCamera;
+struct FConvexVolume;
+struct FMinimalViewInfo;
+
+/**
+ * Estimated render cost of a single primitive as seen from a camera
+ */
+struct BATCHPROFILER_API FStaticCostPrimitive
+{
+	FString Name;
+	FString AssetName;
+	int32 LODIndex = 0;
+	int32 Instances = 1;
+	int64 Triangles = 0;
+	int32 Materials = 0;
+	int32 Sections = 0;
+	float ScreenSize = 0.f;
+};
+
+/**
+ * Estimated render cost of a camera frustum, gathered on the CPU without rendering
+ */
+struct BATCHPROFILER_API FStaticCostReport
+{
+	FString CameraName;
+	int32 VisiblePrimitives = 0;
+	int64 Triangles = 0;
+	int32 Materials = 0;
+	int32 Sections = 0;
+	// Screen coverage of every visible primitive summed up, overlapping primitives are counted more than once
+	float SummedPrimitiveCoverage = 0.f;
+	int32 ShadowCastingLights = 0;
+	int32 DynamicShadowCasters = 0;
+	TArray<FStaticCostPrimitive> TopPrimitives;
+};
+
+/**
+ * Estimates per camera render cost from primitive bounds, selected LODs, materials and shadow casting lights
+ */
+class BATCHPROFILER_API FStaticCostAnalyzer
+{
+public:
+	explicit FStaticCostAnalyzer(const UWorld* World);
+
+	TArray<FStaticCostReport> Analyze(const TArray<AProfilingCamera*>& Cameras, const int32 TopCount) const;
+	static void WriteReport(const TArray<FStaticCostReport>& Reports);
+
+private:
+	struct FPrimitiveEntry
+	{
+		FString Name;
+		FString AssetName;
+		FVector Origin;
+		FVector BoxExtent;
+		float SphereRadius = 0.f;
+		float MaxDrawDistance = 0.f;
+		int32 ForcedLODIndex = INDEX_NONE;
+		int32 Materials = 0;
+		bool bCastsDynamicShadow = false;
+		TArray<float, TInlineAllocator<8>> LODScreenSizes;
+		TArray<int32, TInlineAllocator<8>> LODTriangles;
+		TArray<int32, TInlineAllocator<8>> LODSections;
+
+		// World bounds of each instance of instanced meshes, instances are culled and select their LOD one by one
+		TArray<FBoxSphereBounds> InstanceBounds;
+	};
+
+	struct FLightEntry
+	{
+		FSphere Bounds;
+		bool bIsDirectional = false;
+	};
+
+	void CachePrimitives(const UWorld* World);
+	void CacheLights(const UWorld* World);
+	static int32 SelectLOD(const FPrimitiveEntry& Primitive, const float ScreenRadiusSquared);
+	static bool IsBoundsVisible(const FPrimitiveEntry& Primitive, const FBoxSphereBounds& Bounds, const FMinimalViewInfo& ViewInfo, const FConvexVolume& Frustum,
+		const float ScreenMultiple, float& OutScreenRadiusSquared);
+
+	TArray<FPrimitiveEntry> Primitives;
+	TArray<FLightEntry> Lights;
+};
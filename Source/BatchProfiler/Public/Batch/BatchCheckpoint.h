@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BatchProfilerSettings.h"
+#include "Capture/CaptureCollector.h"
+
+/**
+ * Result of one map of a map batch
+ */
+struct BATCHPROFILER_API FMapBatchResult
+{
+	FString Map;
+	FString Status;
+	double LoadSecs = 0.0;
+	TArray<FCameraCaptureSummary> Summaries;
+};
+
+/**
+ * Progress of a running batch, saved after every camera so a crashed, hung or killed batch can be resumed.
+ * The camera being captured is saved before its capture starts, if the process dies it is recorded as failed on resume.
+ * Map batches also save the camera set file, the results of finished maps, the map index and whether the process died
+ * while that map was loading.
+ */
+class BATCHPROFILER_API FBatchCheckpoint
+{
+public:
+	static FString GetCheckpointPath();
+	static void Discard();
+
+	bool Load();
+	void BeginMap(const FString& InCameraSetFile, const int32 InMapIndex, const EProfilingCaptureBackend InBackend, const float InCaptureValue, const bool bResume);
+	void Begin(const FString& InMap, const EProfilingCaptureBackend InBackend, const float InCaptureValue, const bool bResume, const FString& InCameraSetFile, const int32 InMapIndex);
+	void Finish();
+	void SaveMapResults(const TArray<FMapBatchResult>& InMapResults);
+	bool IsActive() const { return bIsActive; }
+
+	void BeginCamera(const FString& CameraName);
+	void CompleteCamera(const FString& CameraName, const FCameraCaptureSummary* Summary);
+	void FailCamera(const FString& CameraName, const FString& Reason);
+	bool IsCameraProcessed(const FString& CameraName) const;
+
+	const FString& GetMap() const { return Map; }
+	EProfilingCaptureBackend GetBackend() const { return Backend; }
+	float GetCaptureValue() const { return CaptureValue; }
+	const FString& GetCameraSetFile() const { return CameraSetFile; }
+	int32 GetMapIndex() const { return MapIndex; }
+	bool IsLoadingMap() const { return bIsLoadingMap; }
+	const TArray<FMapBatchResult>& GetMapResults() const { return MapResults; }
+	const TArray<FCameraCaptureSummary>& GetSummaries() const { return Summaries; }
+
+private:
+	void Save() const;
+	void ResetProgress();
+
+	bool bIsActive = false;
+	FString Map;
+	EProfilingCaptureBackend Backend = EProfilingCaptureBackend::Trace;
+	float CaptureValue = 0.f;
+	FString CameraSetFile;
+	int32 MapIndex = INDEX_NONE;
+	bool bIsLoadingMap = false;
+	FString InProgressCamera;
+	TArray<FString> CompletedCameras;
+	TArray<TPair<FString, FString>> FailedCameras;
+	TArray<FCameraCaptureSummary> Summaries;
+	TArray<FMapBatchResult> MapResults;
+};
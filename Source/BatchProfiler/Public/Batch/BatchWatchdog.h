@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include <atomic>
+
+class FRunnableThread;
+
+/**
+ * Ends the process when the game thread stops sending heartbeats during a batch, so a hung capture does not block a
+ * build machine. The checkpoint already holds the camera in progress, relaunching with -BatchProfilerResume skips it.
+ */
+class BATCHPROFILER_API FBatchWatchdog : public FRunnable
+{
+public:
+	explicit FBatchWatchdog(const double InHangSeconds);
+	virtual ~FBatchWatchdog() override;
+
+	void Heartbeat();
+
+	/** FRunnable Implementation */
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	double HangSeconds;
+	std::atomic<double> LastHeartbeat;
+	FEvent* StopEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CameraSet.generated.h"
+
+/**
+ * A profiling camera stored outside of the map package
+ */
+USTRUCT()
+struct BATCHPROFILER_API FProfilingCameraDefinition
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Name;
+
+	UPROPERTY()
+	FVector Location = FVector::ZeroVector;
+
+	UPROPERTY()
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	UPROPERTY()
+	float FieldOfView = 90.f;
+
+	// Average frame time budget of the view in milliseconds, 0 for no budget
+	UPROPERTY()
+	float FrameBudgetMs = 0.f;
+};
+
+/**
+ * Cameras of a single map, placed cameras of the map are used when no cameras are defined
+ */
+USTRUCT()
+struct BATCHPROFILER_API FProfilingCameraSet
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Map;
+
+	UPROPERTY()
+	TArray<FProfilingCameraDefinition> Cameras;
+};
+
+/**
+ * Camera set file listing the maps of a multi map batch
+ * {
+ *     "Maps": [
+ *         {
+ *             "Map": "/Game/Maps/Arena",
+ *             "Cameras": [
+ *                 { "Name": "Entrance", "Location": { "X": 0, "Y": 0, "Z": 200 }, "Rotation": { "Pitch": -10, "Yaw": 90, "Roll": 0 }, "FieldOfView": 90, "FrameBudgetMs": 16.6 }
+ *             ]
+ *         }
+ *     ]
+ * }
+ */
+USTRUCT()
+struct BATCHPROFILER_API FProfilingCameraSetFile
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FProfilingCameraSet> Maps;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BatchProfilerSettings.h"
+#include "Batch/BatchCheckpoint.h"
+#include "Batch/CameraSet.h"
+#include "Capture/CaptureCollector.h"
+#include "Containers/Ticker.h"
+#include "Utilities/MapLoader.h"
+
+class FBatchProfilerModule;
+
+/**
+ * Walks the maps of a camera set file in one process: loads each map, measures its load time,
+ * spawns the transient cameras of the map and runs the batch on them.
+ */
+class BATCHPROFILER_API FMapBatch
+{
+public:
+	explicit FMapBatch(FBatchProfilerModule& InProfilerModule);
+	~FMapBatch();
+
+	bool Start(const FString& CameraSetPath, const EProfilingCaptureBackend InBackend, const float InCaptureValue, const int32 ResumeMapIndex = INDEX_NONE);
+	void Stop();
+	bool IsRunning() const { return TickerHandle.IsValid(); }
+
+	static bool LoadCameraSetFile(const FString& CameraSetPath, FProfilingCameraSetFile& OutCameraSetFile);
+
+private:
+	enum class EPhase : uint8
+	{
+		StartingMap,
+		LoadingMap,
+		WaitingForCameras,
+		Capturing
+	};
+
+	bool Tick(float DeltaTime);
+	void StartMap();
+	void OnMapLoaded(UWorld* World, double LoadSecs);
+	void SpawnCameras(UWorld* World, const FProfilingCameraSet& CameraSet) const;
+	void OnCaptureComplete();
+	void FinishMap(const FString& Status);
+	void WriteReport() const;
+
+	FBatchProfilerModule& ProfilerModule;
+	FProfilingCameraSetFile CameraSetFile;
+	FString CameraSetFilePath;
+	EProfilingCaptureBackend Backend = EProfilingCaptureBackend::Trace;
+	float CaptureValue = 0.f;
+
+	int32 MapIndex = 0;
+	bool bResumeMap = false;
+	EPhase Phase = EPhase::StartingMap;
+	double PhaseTimeout = 0.0;
+	FMapLoader MapLoader;
+	FDelegateHandle CaptureCompleteHandle;
+	TArray<FMapBatchResult> MapResults;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+};
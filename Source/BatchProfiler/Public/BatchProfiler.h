@@ -2,6 +2,16 @@
 
 #include "CoreMinimal.h"
 #include "ProfilingCamera.h"
+#include "Capture/CaptureCollector.h"
+#include "Capture/CVarExperiment.h"
+#include "Capture/LoadSweep.h"
+#include "Capture/ReplayProfiler.h"
+#include "Batch/BatchCheckpoint.h"
+#include "Batch/BatchWatchdog.h"
+#include "Batch/MapBatch.h"
+#include "Benchmark/OverheadBenchmark.h"
+#include "Capture/TraceChannelCalibrator.h"
+#include "Service/ProfilingService.h"
 #include "Modules/ModuleManager.h"
 
 class BATCHPROFILER_API FBatchProfilerModule : public IModuleInterface
@@ -14,6 +24,7 @@ public:
 	/** Camera Registration */
 	void RegisterProfilingCamera(AProfilingCamera* ProfilingCamera);
 	void UnregisterProfilingCamera(AProfilingCamera* ProfilingCamera);
+	AProfilingCamera* FindProfilingCamera(const FString& CameraName) const;
 
 	/** Camera Switch Logic */
 	void NextCamera();
@@ -21,9 +32,26 @@ public:
 	AProfilingCamera* GetNextCamera();
 
 	/** Capture Functions */
-	void CaptureWithInsight(const float CaptureSecs, const bool IsBatch, const bool IsSnapshot) const;
-	void CaptureWithRenderDoc(const int FrameCount, const bool IsBatch) const;
-	void CompleteCapture() const;
+	void CaptureWithInsight(const float CaptureSecs, const bool IsBatch, const bool IsSnapshot);
+	void CaptureWithRenderDoc(const int FrameCount, const bool IsBatch);
+	void CompleteCapture();
+
+	/** Batch Control */
+	bool StartBatch(const EProfilingCaptureBackend Backend, const float CaptureValue);
+	void CancelBatch();
+	void SetMapBatchProgress(const FString& CameraSetFile, const int32 MapIndex);
+	bool StartOverheadBenchmark(const int32 CameraCount, const float WindowSecs);
+	const FOverheadBenchmark* GetOverheadBenchmark() const { return OverheadBenchmark.Get(); }
+	void SetCameraFilter(const TArray<FString>& CameraNames);
+	TArray<AProfilingCamera*> GetBatchCameras() const;
+	FSimpleMulticastDelegate& OnCaptureComplete() { return CaptureCompleteDelegate; }
+	const TArray<FCameraCaptureSummary>& GetCaptureSummaries() const { return CaptureSummaries; }
+
+	/** Capture Window */
+	void BeginCameraArrival(const AProfilingCamera* Camera);
+	void BeginCaptureWindow(const AProfilingCamera* Camera);
+	void EndCaptureWindow(const AProfilingCamera* Camera);
+	void AbortCaptureWindow();
 
 protected:
 	/** Command Bindings */
@@ -31,13 +59,53 @@ protected:
 	void PrevCameraCommand(const TArray<FString>& Args);
 	void StartInsightCommand(const TArray<FString>& Args, bool IsBatch,  const bool IsSnapshot);
 	void StartRenderDocCommand(const TArray<FString>& Args, bool IsBatch);
+	void CalibrateTraceCommand(const TArray<FString>& Args);
+	void ListTraceChannelsCommand(const TArray<FString>& Args);
+	void AnalyzeStaticCostCommand(const TArray<FString>& Args);
+	void TickDiffCommand(const TArray<FString>& Args);
+	void StartExperimentCommand(const TArray<FString>& Args);
+	void StartSweepCommand(const TArray<FString>& Args);
+	void StartServiceCommand(const TArray<FString>& Args);
+	void StopServiceCommand(const TArray<FString>& Args);
+	void RecordReplayCommand(const TArray<FString>& Args);
+	void StopReplayCommand(const TArray<FString>& Args);
+	void StartReplayCommand(const TArray<FString>& Args);
+	void StartMapBatchCommand(const TArray<FString>& Args);
+	void ResumeBatchCommand(const TArray<FString>& Args);
+	void OverheadBenchmarkCommand(const TArray<FString>& Args);
 	
 private:
 	int CurrentCameraIndex = 0;
 	bool IsInsightActive = false;
 	AProfilingCamera* ActiveCamera = nullptr;
 	TArray<AProfilingCamera*> ProfilingCameras;
+	TArray<FString> CameraFilter;
+	FSimpleMulticastDelegate CaptureCompleteDelegate;
+	TUniquePtr<FTraceChannelCalibrator> TraceChannelCalibrator;
+	TUniquePtr<FCVarExperiment> CVarExperiment;
+	TUniquePtr<FLoadSweep> LoadSweep;
+	TUniquePtr<FProfilingService> ProfilingService;
+	TUniquePtr<FReplayProfiler> ReplayProfiler;
+	TUniquePtr<FMapBatch> MapBatch;
+	TUniquePtr<FOverheadBenchmark> OverheadBenchmark;
+	FFrameStatsRecorder CaptureFrameRecorder;
+	TArray<TSharedRef<ICaptureCollector>> CaptureCollectors;
+	TSharedPtr<class FTickCostCollector> TickCostCollector;
+	TArray<FCameraCaptureSummary> CaptureSummaries;
+	FBatchCheckpoint BatchCheckpoint;
+	FTSTicker::FDelegateHandle WatchdogHandle;
+	TUniquePtr<FBatchWatchdog> BatchWatchdog;
+	double CameraDeadline = 0.0;
+	bool ResumeRequested = false;
+	FString MapBatchFile;
+	int32 MapBatchIndex = INDEX_NONE;
 	const UBatchProfilerSettings* BatchProfilerSettings = GetMutableDefault<UBatchProfilerSettings>();
 	bool TryInitCapture(bool IsBatch);
+	bool BeginCheckpoint(const EProfilingCaptureBackend Backend, const float CaptureValue);
+	void StartMapBatch(const FString& CameraSetFile, const EProfilingCaptureBackend Backend, const float CaptureValue, const int32 ResumeMapIndex);
+	bool WatchdogTick(float DeltaTime);
+	void StopWatchdog();
+	void HandleStalledCapture();
+	void WriteCaptureSummary() const;
 	// void RegisterKeyBindings();
 };
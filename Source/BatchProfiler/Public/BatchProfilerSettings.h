@@ -1,6 +1,9 @@
 ﻿#pragma once
+#include "UObject/SoftObjectPtr.h"
 #include "BatchProfilerSettings.generated.h"
 
+class AActor;
+
 UENUM(BlueprintType)
 enum class EProfilingTraceChannel : uint8
 {
@@ -22,6 +25,15 @@ enum class EProfilingTraceChannel : uint8
 	LevelSnapshots UMETA(DisplayName = "Level Snapshots")
 };
 
+UENUM(BlueprintType)
+enum class EProfilingCaptureBackend : uint8
+{
+	Trace UMETA(DisplayName = "UE Insights Trace"),
+	Snapshot UMETA(DisplayName = "UE Insights Snapshot"),
+	RenderDoc UMETA(DisplayName = "RenderDoc"),
+	StaticCost UMETA(DisplayName = "Static Cost")
+};
+
 USTRUCT(BlueprintType)
 struct BATCHPROFILER_API FBatchProfilerTraceSettings
 {
@@ -34,6 +46,24 @@ struct BATCHPROFILER_API FBatchProfilerTraceSettings
 	// Array of enabled trace channels (Gpu, Bookmark, Frame, Cpu, and Log are enabled by default)
 	UPROPERTY(Config, EditAnywhere, Category="UE Insights Settings", DisplayName="Enabled Trace Channels", meta = (DisplayOrder = "1"))
 	TArray<EProfilingTraceChannel> EnabledTraceChannels;
+
+	// Defines how many seconds each trace channel is measured during calibration (cp.calibrate.trace)
+	UPROPERTY(Config, EditAnywhere, Category="UE Insights Settings", DisplayName="Calibration Seconds", meta = (DisplayOrder = "2"))
+	float CalibrationSeconds;
+};
+
+USTRUCT(BlueprintType)
+struct BATCHPROFILER_API FBatchProfilerCVarSet
+{
+	GENERATED_BODY()
+
+	// Name of the set used in experiment reports
+	UPROPERTY(Config, EditAnywhere, Category="Experiment Settings", DisplayName="Name", meta = (DisplayOrder = "0"))
+	FString Name;
+
+	// Console variables to apply (ie. r.Shadow.Virtual.Enable 0)
+	UPROPERTY(Config, EditAnywhere, Category="Experiment Settings", DisplayName="Commands", meta = (DisplayOrder = "1"))
+	TArray<FString> Commands;
 };
 
 UCLASS(config = CameraProfilrSettings)
@@ -68,6 +98,10 @@ public:
 	// Custom resolution (ie. 1920x1080)
 	UPROPERTY(Config, EditAnywhere, Category="Generic Settings", DisplayName="Custom Capture Resolution", meta = (DisplayOrder = "5"))
 	FIntPoint CaptureResolution;
+
+	// Shows the name of the captured camera on screen during the capture delay
+	UPROPERTY(Config, EditAnywhere, Category="Generic Settings", DisplayName="Show Camera Name On Screen", meta = (DisplayOrder = "6"))
+	bool ShowCameraNameOnScreen;
 #pragma endregion
 
 #pragma region UE Insights Settings
@@ -90,6 +124,134 @@ public:
 	int RenderDocFrameCaptureCount;
 #pragma endregion
 
+#pragma region Capture Analysis Settings
+	// Attributes tick time to actor classes, component classes, Niagara systems and animated meshes during each capture, requires stats and skews frame times
+	UPROPERTY(Config, EditAnywhere, Category="Capture Analysis Settings", DisplayName="Attribute Tick Cost", meta = (DisplayOrder = "0"))
+	bool AttributeTickCost;
+
+	// Defines how many of the most expensive tick classes are reported per camera
+	UPROPERTY(Config, EditAnywhere, Category="Capture Analysis Settings", DisplayName="Tick Cost Top Count", meta = (DisplayOrder = "1"))
+	int TickCostTopCount;
+
+	// Measures busy ratio of the game, render and worker threads during each capture
+	UPROPERTY(Config, EditAnywhere, Category="Capture Analysis Settings", DisplayName="Measure Thread Occupancy", meta = (DisplayOrder = "2"))
+	bool MeasureThreadOccupancy;
+
+	// Flushes loading before each camera and measures I/O, loaded packages, streaming time and worst frame after the hop
+	UPROPERTY(Config, EditAnywhere, Category="Capture Analysis Settings", DisplayName="Measure Cold Arrival", meta = (DisplayOrder = "3"))
+	bool MeasureColdArrival;
+
+	// Reads perf_event counters (instructions, IPC, cache and branch misses, context switches) of the game and render threads, Linux only
+	UPROPERTY(Config, EditAnywhere, Category="Capture Analysis Settings", DisplayName="Read Performance Counters", meta = (DisplayOrder = "4"))
+	bool ReadPerfCounters;
+
+	// Records garbage collections and UObject creation and destruction by class during each capture
+	UPROPERTY(Config, EditAnywhere, Category="Capture Analysis Settings", DisplayName="Measure Garbage Collection", meta = (DisplayOrder = "5"))
+	bool MeasureGarbageCollection;
+
+	// Runs a full purge during the settle delay of each camera so every capture starts from the same GC state
+	UPROPERTY(Config, EditAnywhere, Category="Capture Analysis Settings", DisplayName="Force Garbage Collection Before Capture", meta = (DisplayOrder = "6"))
+	bool ForceGarbageCollectionBeforeCapture;
+
+	// Number of classes with the most created and destroyed objects reported per camera
+	UPROPERTY(Config, EditAnywhere, Category="Capture Analysis Settings", DisplayName="Churn Top Class Count", meta = (DisplayOrder = "7"))
+	int ChurnTopClassCount;
+
+	// Writes raw per-frame timings, memory and draw counters of each capture into a binary telemetry file (-run=FrameTelemetry)
+	UPROPERTY(Config, EditAnywhere, Category="Capture Analysis Settings", DisplayName="Write Frame Telemetry", meta = (DisplayOrder = "8"))
+	bool WriteFrameTelemetry;
+#pragma endregion
+
+#pragma region Static Cost Settings
+	// Defines how many of the heaviest primitives are reported per camera (cp.analyze.static)
+	UPROPERTY(Config, EditAnywhere, Category="Static Cost Settings", DisplayName="Top Primitive Count", meta = (DisplayOrder = "0"))
+	int StaticCostTopPrimitiveCount;
+#pragma endregion
+
+#pragma region Experiment Settings
+	// CVar sets to compare, the first set is the baseline the others are compared against (cp.batch.experiment)
+	UPROPERTY(Config, EditAnywhere, Category="Experiment Settings", DisplayName="CVar Sets", meta = (DisplayOrder = "0"))
+	TArray<FBatchProfilerCVarSet> ExperimentCVarSets;
+
+	// Defines how many times each set is measured per camera, rounded up to an even count so the set order is counterbalanced
+	UPROPERTY(Config, EditAnywhere, Category="Experiment Settings", DisplayName="Rounds", meta = (DisplayOrder = "1"))
+	int ExperimentRounds;
+
+	// Defines how many seconds to wait after switching sets before measuring
+	UPROPERTY(Config, EditAnywhere, Category="Experiment Settings", DisplayName="Settle Seconds", meta = (DisplayOrder = "2"))
+	float ExperimentSettleSeconds;
+
+	// Defines how many seconds each set is measured per round
+	UPROPERTY(Config, EditAnywhere, Category="Experiment Settings", DisplayName="Window Seconds", meta = (DisplayOrder = "3"))
+	float ExperimentWindowSeconds;
+#pragma endregion
+
+#pragma region Load Sweep Settings
+	// Actor class spawned in steps in front of each camera (cp.batch.sweep)
+	UPROPERTY(Config, EditAnywhere, Category="Load Sweep Settings", DisplayName="Actor Class", meta = (DisplayOrder = "0"))
+	TSoftClassPtr<AActor> SweepActorClass;
+
+	// Population of each step, every camera is captured once per step
+	UPROPERTY(Config, EditAnywhere, Category="Load Sweep Settings", DisplayName="Counts", meta = (DisplayOrder = "1"))
+	TArray<int> SweepCounts;
+
+	// Distance in front of the camera the population is centered at
+	UPROPERTY(Config, EditAnywhere, Category="Load Sweep Settings", DisplayName="Spawn Distance", meta = (DisplayOrder = "2"))
+	float SweepSpawnDistance;
+
+	// Radius of the disc the population is scattered on
+	UPROPERTY(Config, EditAnywhere, Category="Load Sweep Settings", DisplayName="Spawn Radius", meta = (DisplayOrder = "3"))
+	float SweepSpawnRadius;
+
+	// Defines how many seconds to wait after changing the population before measuring
+	UPROPERTY(Config, EditAnywhere, Category="Load Sweep Settings", DisplayName="Settle Seconds", meta = (DisplayOrder = "4"))
+	float SweepSettleSeconds;
+
+	// Defines how many seconds each step is measured
+	UPROPERTY(Config, EditAnywhere, Category="Load Sweep Settings", DisplayName="Window Seconds", meta = (DisplayOrder = "5"))
+	float SweepWindowSeconds;
+#pragma endregion
+
+#pragma region Replay Settings
+	// Replay time in seconds the profiled segment starts at (cp.batch.replay)
+	UPROPERTY(Config, EditAnywhere, Category="Replay Settings", DisplayName="Segment Start Seconds", meta = (DisplayOrder = "0"))
+	float ReplayStartSeconds;
+
+	// Defines how many seconds of the replay are captured from each camera
+	UPROPERTY(Config, EditAnywhere, Category="Replay Settings", DisplayName="Segment Duration Seconds", meta = (DisplayOrder = "1"))
+	float ReplayDurationSeconds;
+
+	// Also records a UE Insights trace of the segment for each camera
+	UPROPERTY(Config, EditAnywhere, Category="Replay Settings", DisplayName="Trace Replay Captures", meta = (DisplayOrder = "2"))
+	bool TraceReplayCaptures;
+#pragma endregion
+
+#pragma region Batch Recovery Settings
+	// Saves batch progress after every camera so an interrupted batch can be resumed (cp.batch.resume or -BatchProfilerResume)
+	UPROPERTY(Config, EditAnywhere, Category="Batch Recovery Settings", DisplayName="Write Checkpoints", meta = (DisplayOrder = "0"))
+	bool WriteBatchCheckpoints;
+
+	// Seconds a camera may exceed its expected capture time before it is recorded as stalled and skipped
+	UPROPERTY(Config, EditAnywhere, Category="Batch Recovery Settings", DisplayName="Stalled Capture Grace Seconds", meta = (DisplayOrder = "1"))
+	float StalledCaptureGraceSeconds;
+
+	// Seconds the game thread may stop responding during a batch before the process exits so it can be relaunched with -BatchProfilerResume, 0 disables
+	UPROPERTY(Config, EditAnywhere, Category="Batch Recovery Settings", DisplayName="Hung Game Thread Seconds", meta = (DisplayOrder = "2"))
+	float HungGameThreadSeconds;
+#pragma endregion
+
+#pragma region Benchmark Settings
+	// Plugin time per frame, or frame time increase beyond its noise, above this fails the overhead benchmark (cp.benchmark.overhead, BatchProfiler.Overhead test)
+	UPROPERTY(Config, EditAnywhere, Category="Benchmark Settings", DisplayName="Overhead Noise Threshold Ms", meta = (DisplayOrder = "0"))
+	float OverheadNoiseThresholdMs;
+#pragma endregion
+
+#pragma region Map Batch Settings
+	// Camera set json used by cp.batch.maps when no file is given, relative to the project directory
+	UPROPERTY(Config, EditAnywhere, Category="Map Batch Settings", DisplayName="Camera Set File", meta = (DisplayOrder = "0"))
+	FString CameraSetFile;
+#pragma endregion
+
 // #pragma region Key Bindings
 // 	UPROPERTY(config, EditAnywhere, Category="Key Bindings",  DisplayName="Next Camera", meta = (DisplayOrder = "0"))
 // 	FKey NextProfilingCameraBinding;
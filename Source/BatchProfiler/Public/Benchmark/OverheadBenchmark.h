@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Capture/FrameStatsRecorder.h"
+
+class AProfilingCamera;
+class FBatchProfilerModule;
+
+/**
+ * Runs a synthetic batch through the capture path of the plugin, best on an empty map, and reports the time the
+ * plugin itself spends per frame and per camera. The result fails when plugin time per frame, or the frame time increase
+ * over the baseline beyond its measurement noise, exceeds the noise threshold. Tick cost attribution is off for that
+ * pass, in stats builds a second pass over the cameras with it on reports its frame time cost.
+ */
+class BATCHPROFILER_API FOverheadBenchmark
+{
+public:
+	FOverheadBenchmark(FBatchProfilerModule& InProfilerModule, const int32 InCameraCount, const float InWindowSecs);
+	~FOverheadBenchmark();
+
+	bool Start(const FSimpleDelegate& InOnComplete);
+	bool IsRunning() const { return TickerHandle.IsValid(); }
+	bool HasPassed() const { return bPassed; }
+	const FString& GetResultText() const { return ResultText; }
+
+private:
+	enum class EPhase : uint8
+	{
+		Baseline,
+		Arrive,
+		Capture
+	};
+
+	// Plugin time and frame times inside the capture windows of one pass over the cameras
+	struct FPassStats
+	{
+		double OverheadSecs = 0.0;
+		int32 Frames = 0;
+		double FrameMsSum = 0.0;
+		double FrameMsSquareSum = 0.0;
+
+		double GetAvgFrameMs() const;
+		double GetFrameVariance() const;
+	};
+
+	bool Tick(float DeltaTime);
+	void StartCamera();
+	void FinishCamera();
+	bool StartTickCostPass();
+	void RestoreTickCostSetting();
+	void DestroyCameras();
+	void WriteReport();
+
+	FBatchProfilerModule& ProfilerModule;
+	int32 CameraCount;
+	float WindowSecs;
+	FSimpleDelegate OnComplete;
+
+	TArray<TWeakObjectPtr<AProfilingCamera>> Cameras;
+	int32 CameraIndex = 0;
+	EPhase Phase = EPhase::Baseline;
+	double PhaseEndTime = 0.0;
+
+	FFrameStatsRecorder BaselineRecorder;
+	FFrameStats BaselineStats;
+
+	// Plugin time inside capture windows, and spent switching cameras outside of them
+	double WindowStartOverhead = 0.0;
+	double SwitchOverheadSecs = 0.0;
+	FPassStats BatchPass;
+
+	// Pass with tick cost attribution on, the setting is restored when the benchmark ends
+	FPassStats TickCostPass;
+	bool bIsTickCostPass = false;
+	bool bOriginalAttributeTickCost = false;
+
+	bool bPassed = false;
+	FString ResultText;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+};
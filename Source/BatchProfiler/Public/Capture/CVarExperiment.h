@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BatchProfilerSettings.h"
+#include "Containers/Ticker.h"
+#include "Capture/FrameStatsRecorder.h"
+
+class AProfilingCamera;
+
+/**
+ * Compares CVar sets at each camera by alternating them in short interleaved windows, counterbalanced per round (ABBA...).
+ * Measuring every set at the same viewpoint within seconds of each other cancels thermal and background drift,
+ * so the paired per round differences are reported with a confidence interval.
+ */
+class BATCHPROFILER_API FCVarExperiment
+{
+public:
+	FCVarExperiment(const TArray<AProfilingCamera*>& InCameras, const TArray<FBatchProfilerCVarSet>& InCVarSets, const int InRounds);
+	~FCVarExperiment();
+
+	void Start(const FSimpleDelegate& InOnComplete);
+	bool IsRunning() const { return TickerHandle.IsValid(); }
+
+private:
+	enum class EPhase : uint8
+	{
+		Arrive,
+		Settle,
+		Measure
+	};
+
+	struct FPairedDelta
+	{
+		double BaselineMean = 0.0;
+		double Mean = 0.0;
+		double ConfidenceInterval = 0.0;
+	};
+
+	bool Tick(float DeltaTime);
+	void StartCamera();
+	void StartWindow();
+	void FinishWindow();
+	int32 GetSetIndex(const int32 InRoundIndex, const int32 InOrderIndex) const;
+	void ApplyCVarSet(const int32 SetIndex) const;
+	void RestoreCVars() const;
+	void WriteReport() const;
+
+	static FPairedDelta ComputePairedDelta(const TArray<float>& Baseline, const TArray<float>& Samples);
+	static double GetStudentT95(const int32 DegreesOfFreedom);
+
+	TArray<AProfilingCamera*> Cameras;
+	TArray<FBatchProfilerCVarSet> CVarSets;
+	int Rounds;
+	TMap<FString, FString> OriginalValues;
+	FSimpleDelegate OnComplete;
+
+	// Window results indexed by [Camera][Set][Round]
+	TArray<TArray<TArray<FFrameStats>>> Results;
+
+	int32 CameraIndex = 0;
+	int32 RoundIndex = 0;
+	int32 OrderIndex = 0;
+	EPhase Phase = EPhase::Arrive;
+	double PhaseEndTime = 0.0;
+
+	FFrameStatsRecorder Recorder;
+	FTSTicker::FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Capture/FrameStatsRecorder.h"
+
+class AProfilingCamera;
+
+/**
+ * Measurements of a single camera capture window
+ */
+struct BATCHPROFILER_API FCameraCaptureSummary
+{
+	FString CameraName;
+	FFrameStats FrameStats;
+
+	// Additional named metrics added by capture collectors
+	TArray<TPair<FString, double>> Metrics;
+
+	void AddMetric(const FString& Name, const double Value)
+	{
+		Metrics.Emplace(Name, Value);
+	}
+};
+
+/**
+ * Collects additional measurements during each camera capture window
+ */
+class BATCHPROFILER_API ICaptureCollector
+{
+public:
+	virtual ~ICaptureCollector() = default;
+
+	/** Called before a batch starts */
+	virtual void BeginBatch() {}
+
+	/** Called before the view is moved to a camera, ahead of the settle delay */
+	virtual void BeginArrival(const AProfilingCamera* Camera) {}
+
+	/** Called when the capture window of a camera starts */
+	virtual void BeginCapture(const AProfilingCamera* Camera) = 0;
+
+	/** Called when the capture window of a camera ends, stores measurements into the summary */
+	virtual void EndCapture(FCameraCaptureSummary& Summary) = 0;
+
+	/** Called after every camera is captured, writes collector specific reports */
+	virtual void CompleteBatch(const TArray<FCameraCaptureSummary>& Summaries) {}
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Capture/CaptureCollector.h"
+#include "Containers/Ticker.h"
+
+/**
+ * Measures the streaming cost of moving the view to a camera, the window the settle delay otherwise hides.
+ * Loading is flushed to a quiet state before each hop, then bytes read, read requests, loaded packages,
+ * time until streaming completes and the worst frame are recorded from the hop onwards.
+ */
+class BATCHPROFILER_API FColdArrivalCollector : public ICaptureCollector
+{
+public:
+	virtual ~FColdArrivalCollector() override;
+
+	virtual void BeginArrival(const AProfilingCamera* Camera) override;
+	virtual void BeginCapture(const AProfilingCamera* Camera) override;
+	virtual void EndCapture(FCameraCaptureSummary& Summary) override;
+
+private:
+	struct FIOCounters
+	{
+		uint64 ReadBytes = 0;
+		uint64 ReadRequests = 0;
+	};
+
+	static bool GetProcessIOCounters(FIOCounters& OutCounters);
+	static bool IsStreamingComplete();
+
+	bool Tick(float DeltaTime);
+	void OnAssetLoaded(UObject* Asset);
+	void CompleteArrival();
+	void StopArrival();
+
+	FTSTicker::FDelegateHandle TickerHandle;
+	FDelegateHandle AssetLoadedHandle;
+
+	bool bIsArriving = false;
+	double ArrivalStartTime = 0.0;
+	double StreamingCompleteTime = 0.0;
+	int32 ArrivalTicks = 0;
+	int32 CompleteTicks = 0;
+	FIOCounters StartCounters;
+	TSet<FName> LoadedPackages;
+	float WorstFrameMs = 0.f;
+
+	// Results of the last arrival, reported with the capture window of the camera
+	bool bHasResult = false;
+	FIOCounters ArrivalCounters;
+	int32 ArrivalPackages = 0;
+	double StreamingSecs = -1.0;
+	float ArrivalWorstFrameMs = 0.f;
+};
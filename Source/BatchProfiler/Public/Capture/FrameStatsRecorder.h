@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+/**
+ * Aggregated frame timings of a capture window
+ */
+struct BATCHPROFILER_API FFrameStats
+{
+	int32 FrameCount = 0;
+	double DurationSecs = 0.0;
+	float AvgFrameMs = 0.f;
+	float StdDevFrameMs = 0.f;
+	float P95FrameMs = 0.f;
+	float MaxFrameMs = 0.f;
+	float AvgGameThreadMs = 0.f;
+	float AvgRenderThreadMs = 0.f;
+	float AvgGPUMs = 0.f;
+};
+
+/**
+ * Samples frame, game thread, render thread and GPU times every frame while recording
+ */
+class BATCHPROFILER_API FFrameStatsRecorder
+{
+public:
+	~FFrameStatsRecorder();
+
+	void Start();
+	FFrameStats Stop();
+	bool IsRecording() const { return TickerHandle.IsValid(); }
+
+private:
+	bool Tick(float DeltaTime);
+
+	FTSTicker::FDelegateHandle TickerHandle;
+	double StartTime = 0.0;
+	TArray<float> FrameTimes;
+	double GameThreadMsSum = 0.0;
+	double RenderThreadMsSum = 0.0;
+	double GPUMsSum = 0.0;
+};
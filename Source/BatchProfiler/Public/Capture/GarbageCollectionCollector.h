@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Capture/CaptureCollector.h"
+#include "UObject/UObjectArray.h"
+
+/**
+ * Attributes garbage collection and UObject churn to cameras. Optionally forces a full purge during the settle delay,
+ * then records collection count and duration, object creation and destruction rates and the classes with the most churn.
+ *
+ * The class of every object slot is mirrored from the arrival onwards, a destroyed object may be of a class that is
+ * purged in the same collection, so its class is never read at destruction time.
+ */
+class BATCHPROFILER_API FGarbageCollectionCollector : public ICaptureCollector, public FUObjectArray::FUObjectCreateListener, public FUObjectArray::FUObjectDeleteListener
+{
+public:
+	virtual ~FGarbageCollectionCollector() override;
+
+	virtual void BeginBatch() override;
+	virtual void BeginArrival(const AProfilingCamera* Camera) override;
+	virtual void BeginCapture(const AProfilingCamera* Camera) override;
+	virtual void EndCapture(FCameraCaptureSummary& Summary) override;
+	virtual void CompleteBatch(const TArray<FCameraCaptureSummary>& Summaries) override;
+
+	/** FUObjectArray Listeners */
+	virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override;
+	virtual void NotifyUObjectDeleted(const UObjectBase* Object, int32 Index) override;
+	virtual void OnUObjectArrayShutdown() override;
+
+private:
+	struct FClassChurn
+	{
+		FName ClassName;
+		int64 Created = 0;
+		int64 Destroyed = 0;
+	};
+
+	void StartTracking();
+	void StopTracking();
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	// Guards the class mirror and churn counts, objects are created on loading threads and may be destroyed on the purge thread
+	FCriticalSection TrackingLock;
+	bool bIsTracking = false;
+	bool bIsCollecting = false;
+	TArray<FName> ObjectClassNames;
+	TMap<FName, FClassChurn> ClassChurn;
+	int64 ObjectsCreated = 0;
+	int64 ObjectsDestroyed = 0;
+
+	FDelegateHandle PreGarbageCollectHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+	double CollectStartTime = 0.0;
+	int32 CollectCount = 0;
+	double CollectTotalSecs = 0.0;
+	double CollectMaxSecs = 0.0;
+	double StartTime = 0.0;
+
+	// Classes with the most churn per camera, reported after the batch
+	TMap<FString, TArray<FClassChurn>> CameraTopClasses;
+};
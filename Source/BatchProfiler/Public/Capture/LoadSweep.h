@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Capture/FrameStatsRecorder.h"
+
+class AProfilingCamera;
+
+/**
+ * Captures each camera repeatedly while the population of an actor class grows in steps.
+ * Frame cost is fitted against the population per camera as base + scale * count^k, k above one flags super-linear systems.
+ */
+class BATCHPROFILER_API FLoadSweep
+{
+public:
+	FLoadSweep(const TArray<AProfilingCamera*>& InCameras, UClass* InActorClass, const TArray<int32>& InCounts);
+	~FLoadSweep();
+
+	void Start(const FSimpleDelegate& InOnComplete);
+	bool IsRunning() const { return TickerHandle.IsValid(); }
+
+private:
+	enum class EPhase : uint8
+	{
+		Arrive,
+		Settle,
+		Measure
+	};
+
+	struct FCostFit
+	{
+		double BaseMs = 0.0;
+		double MsPerActor = 0.0;
+		double LinearR2 = 0.0;
+		double Exponent = 0.0;
+		int32 ExponentPoints = 0;
+		bool bIsSuperLinear = false;
+	};
+
+	bool Tick(float DeltaTime);
+	void StartCamera();
+	void StartStep();
+	void FinishStep();
+	void SetPopulation(const int32 Count);
+	void DestroyPopulation();
+	void WriteReport() const;
+
+	static FCostFit FitCost(const TArray<int32>& Counts, const TArray<double>& CostMs);
+
+	TArray<AProfilingCamera*> Cameras;
+	TWeakObjectPtr<UClass> ActorClass;
+	TArray<int32> Counts;
+	FSimpleDelegate OnComplete;
+
+	// Step results indexed by [Camera][Step]
+	TArray<TArray<FFrameStats>> Results;
+
+	TArray<TWeakObjectPtr<AActor>> SpawnedActors;
+	FRandomStream SpawnStream;
+
+	int32 CameraIndex = 0;
+	int32 StepIndex = 0;
+	EPhase Phase = EPhase::Arrive;
+	double PhaseEndTime = 0.0;
+
+	FFrameStatsRecorder Recorder;
+	FTSTicker::FDelegateHandle TickerHandle;
+};
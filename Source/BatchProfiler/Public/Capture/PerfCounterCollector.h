@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Capture/CaptureCollector.h"
+
+/**
+ * Reads Linux perf_event counters of the game and render threads during each capture window.
+ * Hardware counters (instructions, cycles, cache and branch misses) are read as one group led by cycles so ratios
+ * are counted over the same intervals, they fall back to a software group when the kernel does not permit them.
+ * Context switches are always read. Other platforms report no counters.
+ */
+class BATCHPROFILER_API FPerfCounterCollector : public ICaptureCollector
+{
+public:
+	virtual ~FPerfCounterCollector() override;
+
+	virtual void BeginCapture(const AProfilingCamera* Camera) override;
+	virtual void EndCapture(FCameraCaptureSummary& Summary) override;
+
+private:
+	enum ECounter : uint8
+	{
+		Instructions,
+		Cycles,
+		CacheMisses,
+		BranchMisses,
+		ContextSwitches,
+		TaskClock,
+		PageFaults,
+		Count
+	};
+
+	struct FCounterGroup
+	{
+		int32 Leader = -1;
+		TArray<ECounter, TInlineAllocator<ECounter::Count>> Counters;
+	};
+
+	struct FThreadCounters
+	{
+		FString Prefix;
+		uint32 ThreadId = 0;
+		int32 Descriptors[ECounter::Count];
+		FCounterGroup HardwareGroup;
+		FCounterGroup SoftwareGroup;
+	};
+
+	void OpenThreadCounters(const FString& Prefix, const uint32 ThreadId);
+	static void OpenCounterGroup(FThreadCounters& Counters, FCounterGroup& Group, std::initializer_list<ECounter> GroupCounters);
+	static void ReadCounterGroup(const FCounterGroup& Group, double* OutValues);
+	void CloseCounters();
+
+	TArray<FThreadCounters> ThreadCounters;
+	bool bHasLoggedFallback = false;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+class FBatchProfilerModule;
+
+/**
+ * Plays back the same replay segment from each profiling camera so every camera is measured under identical dynamic load.
+ * The replay is loaded once, each camera seeks back to the segment start and captures for the segment duration.
+ */
+class BATCHPROFILER_API FReplayProfiler
+{
+public:
+	FReplayProfiler(FBatchProfilerModule& InProfilerModule, const TArray<FString>& InCameraNames);
+	~FReplayProfiler();
+
+	bool Start(const FString& InReplayName, const float InStartSecs, const float InDurationSecs, const FSimpleDelegate& InOnComplete);
+	bool IsRunning() const { return TickerHandle.IsValid(); }
+
+	static bool StartRecording(const FString& ReplayName);
+	static void StopRecording();
+
+private:
+	enum class EPhase : uint8
+	{
+		WaitingForReplay,
+		Arrive,
+		Seeking,
+		Capturing
+	};
+
+	bool Tick(float DeltaTime);
+	void StartCamera();
+	void OnGotoTimeComplete(const bool bWasSuccessful, const uint32 InSeekId);
+	void FinishCamera();
+	void Finish();
+	class UDemoNetDriver* GetDemoNetDriver() const;
+
+	FBatchProfilerModule& ProfilerModule;
+	TArray<FString> CameraNames;
+	FString ReplayName;
+	float StartSecs = 0.f;
+	float DurationSecs = 0.f;
+	FSimpleDelegate OnComplete;
+
+	int32 CameraIndex = 0;
+
+	// Identifies the pending seek, a late callback of a timed out seek must not start a window
+	uint32 SeekId = 0;
+	EPhase Phase = EPhase::WaitingForReplay;
+	double PhaseEndTime = 0.0;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+};
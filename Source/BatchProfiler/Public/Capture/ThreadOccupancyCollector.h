@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Capture/CaptureCollector.h"
+
+/**
+ * Measures how busy the game, render, RHI and task graph worker threads are during each capture window.
+ * Thread CPU time is sampled from the OS at the window bounds, so the measurement adds no per frame overhead.
+ */
+class BATCHPROFILER_API FThreadOccupancyCollector : public ICaptureCollector
+{
+public:
+	virtual void BeginBatch() override;
+	virtual void BeginCapture(const AProfilingCamera* Camera) override;
+	virtual void EndCapture(FCameraCaptureSummary& Summary) override;
+	virtual void CompleteBatch(const TArray<FCameraCaptureSummary>& Summaries) override;
+
+private:
+	struct FThreadSample
+	{
+		uint32 ThreadId = 0;
+		FString Name;
+		FString Group;
+		double CpuSecs = 0.0;
+	};
+
+	struct FThreadOccupancy
+	{
+		FString Name;
+		FString Group;
+		double CpuMs = 0.0;
+		double BusyPct = 0.0;
+	};
+
+	struct FCameraOccupancy
+	{
+		TArray<FThreadOccupancy> Threads;
+		double GameThreadBusyPct = 0.0;
+		double RenderThreadBusyPct = 0.0;
+		double RHIThreadBusyPct = 0.0;
+		double WorkerBusyPct = 0.0;
+		double WorkerMaxBusyPct = 0.0;
+		int32 WorkerCount = 0;
+		double Parallelism = 0.0;
+		// Share of the frame time the slower of the game and render threads was busy, excluding waits
+		double SerialPct = 0.0;
+		FString Bottleneck;
+	};
+
+	static void SampleThreads(TArray<FThreadSample>& OutSamples);
+	static bool GetThreadCpuSeconds(const uint32 ThreadId, double& OutSeconds);
+	static FString GetThreadGroup(const uint32 ThreadId, const FString& ThreadName);
+
+	bool bIsCollecting = false;
+	double StartTime = 0.0;
+	TArray<FThreadSample> StartSamples;
+
+	// Occupancy of each camera in the last batch
+	TMap<FString, FCameraOccupancy> CameraOccupancies;
+};
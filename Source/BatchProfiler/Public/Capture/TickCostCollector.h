@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Capture/CaptureCollector.h"
+
+/**
+ * Attributes tick time to actor classes, component classes, Niagara systems and animated skeletal meshes.
+ * Uses the per object cycle stats the engine already emits around every tick function, aggregated on the stats thread.
+ * Those stats are only emitted in stats builds and slow the game thread down, summaries captured with them are marked
+ * with TickCostSkewed and the overhead benchmark reports their frame time cost.
+ */
+class BATCHPROFILER_API FTickCostCollector : public ICaptureCollector
+{
+public:
+	virtual ~FTickCostCollector() override;
+
+	virtual void BeginBatch() override;
+	virtual void BeginCapture(const AProfilingCamera* Camera) override;
+	virtual void EndCapture(FCameraCaptureSummary& Summary) override;
+	virtual void CompleteBatch(const TArray<FCameraCaptureSummary>& Summaries) override;
+
+	void LogDiff(const FString& CameraA, const FString& CameraB) const;
+
+private:
+	struct FTickTarget
+	{
+		FString Category;
+		FString Name;
+	};
+
+	struct FTickCost
+	{
+		FString Category;
+		FString Name;
+		int32 Instances = 0;
+		float MsPerFrame = 0.f;
+	};
+
+	void MapTickTargets(const UWorld* World);
+	void AddTickTarget(const UObject* Object, const FString& Category, const FString& Name);
+	void OnNewStatsFrame(int64 Frame);
+	void StopCollecting();
+
+#if STATS
+	// Stats delegates are broadcast on the stats thread and may only be bound there
+	static void RunOnStatsThread(const FSimpleDelegate& Task);
+	void AddNewFrameHandler();
+	void RemoveNewFrameHandler();
+#endif
+
+	bool bIsCollecting = false;
+	FDelegateHandle NewFrameHandle;
+
+	// Accessed from the stats thread while collecting
+	FCriticalSection CollectLock;
+	TMap<FName, FTickTarget> StatTargets;
+	TMap<FName, double> StatMilliseconds;
+	int32 StatFrameCount = 0;
+
+	// Ranked tick costs of each camera in the last batch
+	TMap<FString, TArray<FTickCost>> CameraTickCosts;
+};
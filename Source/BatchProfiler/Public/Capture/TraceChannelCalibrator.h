@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Capture/FrameStatsRecorder.h"
+
+/**
+ * Captures the active view with each trace channel on its own and reports the overhead of every channel
+ */
+class BATCHPROFILER_API FTraceChannelCalibrator
+{
+public:
+	FTraceChannelCalibrator(const FString& InCameraName, const float InSettleSecs, const float InMeasureSecs);
+	~FTraceChannelCalibrator();
+
+	void Start(const FSimpleDelegate& InOnComplete);
+	bool IsRunning() const { return TickerHandle.IsValid(); }
+
+private:
+	enum class EPhase : uint8
+	{
+		Settle,
+		Warmup,
+		Measure
+	};
+
+	struct FCalibrationStep
+	{
+		FString ChannelName;
+		bool bIsRegistered = true;
+		FFrameStats FrameStats;
+		double BytesPerSec = 0.0;
+	};
+
+	bool Tick(float DeltaTime);
+	void StartStep();
+	void FinishStep();
+	void WriteReport() const;
+	static uint64 GetTracedBytes();
+
+	FString CameraName;
+	float SettleSecs;
+	float MeasureSecs;
+	FSimpleDelegate OnComplete;
+
+	TArray<FCalibrationStep> Steps;
+	int32 StepIndex = 0;
+	EPhase Phase = EPhase::Settle;
+	double PhaseEndTime = 0.0;
+	uint64 MeasureStartBytes = 0;
+
+	FFrameStatsRecorder Recorder;
+	FTSTicker::FDelegateHandle TickerHandle;
+};
@@ -25,11 +25,18 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Profiling")
 	FString CameraName;
 
+	// Average frame time budget of the view in milliseconds, 0 for no budget
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Profiling", meta = (ClampMin = "0"))
+	float FrameBudgetMs = 0.f;
+
 	void ActivateCamera();
 	void DeactivateCamera() const;
 
 	void StartInsightCapture(const float CaptureSecs, bool IsBatch, bool IsSnapshot);
 	void StartRenderDoc(const int FrameCount, bool IsBatch);
+	void CancelCapture();
+
+	FString GetFilename() const;
 
 protected:
 	virtual void BeginPlay() override;
@@ -40,12 +47,14 @@ private:
 	FBatchProfilerModule* ProfilerModule;
 	UCameraComponent* ProfilingCameraComponent;
 	const UBatchProfilerSettings* BatchProfilerSettings = GetMutableDefault<UBatchProfilerSettings>();
+
+	// Pending capture timers, kept so a stalled capture can be cancelled
+	FTimerHandle DelayTimerHandle;
+	mutable FTimerHandle CaptureTimerHandle;
 	
 	void RegisterCamera();
 	void UnregisterCamera();
 
 	void CaptureInsight(const float CaptureSecs, bool IsBatch, bool IsSnapshot) const;
 	void CaptureRenderDoc(const int FrameCount, bool IsBatch) const;
-
-	FString GetFilename() const;
 };
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BatchProfilerSettings.h"
+#include "Containers/Ticker.h"
+#include "Utilities/MapLoader.h"
+
+class FBatchProfilerModule;
+
+/**
+ * Keeps a warm game or editor instance running batch requests from a local spool directory.
+ *
+ * Jobs are json files dropped into <SpoolDirectory>/Queue and processed oldest first:
+ * {
+ *     "Map": "/Game/Maps/Arena",
+ *     "Cameras": ["Entrance", "Atrium"],
+ *     "Backend": "Trace",
+ *     "CaptureValue": 5,
+ *     "Settings": { "DelayBeforeEachCapture": 2, "AttributeTickCost": true }
+ * }
+ * Running jobs are moved to Running, finished jobs to Done or Failed next to a <Job>.result.json.
+ */
+class BATCHPROFILER_API FProfilingService
+{
+public:
+	explicit FProfilingService(FBatchProfilerModule& InProfilerModule);
+	~FProfilingService();
+
+	void Start(const FString& InSpoolDirectory);
+	void Stop();
+	bool IsRunning() const { return TickerHandle.IsValid(); }
+
+	static FString GetDefaultSpoolDirectory();
+
+private:
+	enum class EJobState : uint8
+	{
+		Idle,
+		LoadingMap,
+		WaitingForCameras,
+		Capturing
+	};
+
+	struct FProfilingJob
+	{
+		FString Name;
+		FString Map;
+		TArray<FString> Cameras;
+		EProfilingCaptureBackend Backend = EProfilingCaptureBackend::Trace;
+		float CaptureValue = 0.f;
+		TMap<FString, FString> Settings;
+		FDateTime StartTime;
+		double MapLoadSecs = 0.0;
+	};
+
+	bool Tick(float DeltaTime);
+	void TryStartNextJob();
+	bool ParseJob(const FString& JobPath, FProfilingJob& OutJob, FString& OutError) const;
+	void OnMapLoaded(UWorld* World, double LoadSecs);
+	void StartCapture();
+	void OnCaptureComplete();
+	void FinishJob(const bool bSuccess, const FString& Error);
+
+	void ApplySettingsOverrides(const TMap<FString, FString>& Settings);
+	void RestoreSettings();
+
+	FString GetJobPath(const TCHAR* Folder, const FString& FileName) const;
+
+	FBatchProfilerModule& ProfilerModule;
+	FString SpoolDirectory;
+	FTSTicker::FDelegateHandle TickerHandle;
+	double NextPollTime = 0.0;
+	double StateTimeout = 0.0;
+
+	EJobState JobState = EJobState::Idle;
+	FProfilingJob ActiveJob;
+	FMapLoader MapLoader;
+	FDelegateHandle CaptureCompleteHandle;
+	TArray<TPair<FProperty*, FString>> OriginalSettings;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Per-frame columns of a telemetry region, new columns are only ever appended
+ */
+enum class EFrameTelemetryColumn : uint8
+{
+	FrameMs,
+	GameThreadMs,
+	RenderThreadMs,
+	RHIThreadMs,
+	GPUMs,
+	UsedPhysicalMB,
+	DrawCalls,
+	PrimitivesDrawn,
+	Count
+};
+
+/**
+ * Binary layout of a frame telemetry file (.bpft), little endian and 4 byte aligned throughout:
+ *
+ * FHeader
+ * FRegionHeader + UTF-8 camera name padded to 4 bytes,
+ *     uint32 FrameNumbers[FrameCount], float Column[ColumnCount][FrameCount]                 (one region per camera window)
+ * ...
+ * FIndexEntry + UTF-8 camera name padded to 4 bytes                                        (one entry per region)
+ * FFooter
+ *
+ * Regions are appended and flushed after every camera. Index and footer are written when the batch completes,
+ * files of interrupted batches are read by walking the region headers, which carry the camera name since version 2.
+ */
+namespace FrameTelemetryFormat
+{
+	static constexpr uint32 HeaderMagic = 0x54465042; // BPFT
+	static constexpr uint32 RegionMagic = 0x47525042; // BPRG
+	static constexpr uint32 FooterMagic = 0x58495042; // BPIX
+	static constexpr uint16 Version = 2;
+	static constexpr TCHAR Extension[] = TEXT(".bpft");
+
+#pragma pack(push, 4)
+	struct FHeader
+	{
+		uint32 Magic = HeaderMagic;
+		uint16 Version = FrameTelemetryFormat::Version;
+		uint16 ColumnCount = static_cast<uint16>(EFrameTelemetryColumn::Count);
+		int64 BatchStartTicks = 0;
+		uint32 Reserved[4] = {};
+	};
+
+	struct FRegionHeader
+	{
+		uint32 Magic = RegionMagic;
+		uint32 CameraId = 0;
+		uint32 FrameCount = 0;
+		uint32 NameLength = 0;
+	};
+
+	struct FIndexEntry
+	{
+		uint32 CameraId = 0;
+		uint32 FrameCount = 0;
+		uint64 RegionOffset = 0;
+		uint32 NameLength = 0;
+	};
+
+	struct FFooter
+	{
+		uint64 IndexOffset = 0;
+		uint32 RegionCount = 0;
+		uint32 Magic = FooterMagic;
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(FHeader) == 32 && sizeof(FRegionHeader) == 16 && sizeof(FIndexEntry) == 20 && sizeof(FFooter) == 16, "Frame telemetry layout changed");
+
+	/** Size of a region including its header and camera name */
+	inline uint64 GetRegionSize(const uint32 FrameCount, const uint16 ColumnCount, const uint32 NameLength)
+	{
+		return sizeof(FRegionHeader) + Align(static_cast<uint64>(NameLength), 4) + static_cast<uint64>(FrameCount) * sizeof(uint32) * (1 + ColumnCount);
+	}
+
+	BATCHPROFILER_API const TCHAR* GetColumnName(const EFrameTelemetryColumn Column);
+	BATCHPROFILER_API FString GetTelemetryDirectory();
+}
+
+/**
+ * Frames of one camera window, columns point into the mapped file
+ */
+struct BATCHPROFILER_API FFrameTelemetryRegion
+{
+	uint32 CameraId = 0;
+	FString CameraName;
+	uint32 FrameCount = 0;
+	const uint32* FrameNumbers = nullptr;
+	TArray<const float*, TInlineAllocator<static_cast<int32>(EFrameTelemetryColumn::Count)>> Columns;
+
+	TArrayView<const uint32> GetFrameNumbers() const { return TArrayView<const uint32>(FrameNumbers, FrameCount); }
+	TArrayView<const float> GetColumn(const EFrameTelemetryColumn Column) const
+	{
+		const int32 ColumnIndex = static_cast<int32>(Column);
+		return Columns.IsValidIndex(ColumnIndex) ? TArrayView<const float>(Columns[ColumnIndex], FrameCount) : TArrayView<const float>();
+	}
+};
+
+/**
+ * Memory maps a frame telemetry file and exposes its regions without copying frame data.
+ * Column views are valid as long as the reader is alive.
+ */
+class BATCHPROFILER_API FFrameTelemetryReader
+{
+public:
+	FFrameTelemetryReader() = default;
+	~FFrameTelemetryReader();
+
+	FFrameTelemetryReader(const FFrameTelemetryReader&) = delete;
+	FFrameTelemetryReader& operator=(const FFrameTelemetryReader&) = delete;
+
+	bool Open(const FString& Filename);
+	void Close();
+
+	bool IsComplete() const { return bIsComplete; }
+	FDateTime GetBatchStartTime() const { return FDateTime(BatchStartTicks); }
+	const TArray<FFrameTelemetryRegion>& GetRegions() const { return Regions; }
+
+private:
+	bool ReadIndex(const uint8* Data, const uint64 Size, const uint16 ColumnCount);
+	bool ScanRegions(const uint8* Data, const uint64 Size, const uint16 ColumnCount);
+	bool AddRegion(const uint8* Data, const uint64 Size, const uint64 Offset, const uint16 ColumnCount, const FString& CameraName);
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<FFrameTelemetryRegion> Regions;
+	int64 BatchStartTicks = 0;
+	bool bIsComplete = false;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Capture/CaptureCollector.h"
+#include "Containers/Ticker.h"
+#include "Telemetry/FrameTelemetry.h"
+
+class IFileHandle;
+
+/**
+ * Records raw per-frame timings, memory and draw counters of every capture window into a columnar telemetry file
+ * (FrameTelemetry_<Timestamp>.bpft) so batches can be re-analyzed at frame level without keeping traces.
+ */
+class BATCHPROFILER_API FFrameTelemetryCollector : public ICaptureCollector
+{
+public:
+	virtual ~FFrameTelemetryCollector() override;
+
+	virtual void BeginBatch() override;
+	virtual void BeginCapture(const AProfilingCamera* Camera) override;
+	virtual void EndCapture(FCameraCaptureSummary& Summary) override;
+	virtual void CompleteBatch(const TArray<FCameraCaptureSummary>& Summaries) override;
+
+private:
+	struct FRegionEntry
+	{
+		FString CameraName;
+		uint32 FrameCount = 0;
+		uint64 RegionOffset = 0;
+	};
+
+	bool Tick(float DeltaTime);
+	bool OpenFile();
+	void WriteRegion(const FString& CameraName);
+	void CloseFile();
+	bool Write(const void* Data, const int64 Size);
+
+	TUniquePtr<IFileHandle> FileHandle;
+	FString Filename;
+	TArray<FRegionEntry> WrittenRegions;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+	TArray<uint32> FrameNumbers;
+	TArray<float> Columns[static_cast<int32>(EFrameTelemetryColumn::Count)];
+
+	// Memory stats are expensive to query, they are sampled at a lower rate and repeated in between
+	double NextMemorySampleTime = 0.0;
+	float UsedPhysicalMB = 0.f;
+};
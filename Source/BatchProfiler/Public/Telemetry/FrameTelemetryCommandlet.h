@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FrameTelemetryCommandlet.generated.h"
+
+/**
+ * Scans frame telemetry files and summarizes one column per file and camera into TelemetryScan_<Timestamp>.csv
+ *
+ * -run=FrameTelemetry [-Dir=<Directory>] [-Since=<YYYY.MM.DD>] [-Camera=<Name>] [-Column=<FrameMs>]
+ */
+UCLASS()
+class BATCHPROFILER_API UFrameTelemetryCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UFrameTelemetryCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+
+/**
+ * Opens a map in the running game or play in editor session and measures how long it takes to load
+ */
+class BATCHPROFILER_API FMapLoader
+{
+public:
+	/** Called with the loaded world and load time, world is null if loading failed */
+	DECLARE_DELEGATE_TwoParams(FOnMapLoaded, UWorld* /*World*/, double /*LoadSecs*/);
+
+	~FMapLoader();
+
+	bool LoadMap(const FString& MapName, const FOnMapLoaded& InOnLoaded);
+	bool IsLoading() const { return PostLoadMapHandle.IsValid(); }
+	static bool IsMapLoaded(const FString& MapName);
+
+private:
+	void OnPostLoadMap(UWorld* World);
+	void OnTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& Error);
+	void Finish(UWorld* World);
+
+	FString PendingMapName;
+	double StartTime = 0.0;
+	FOnMapLoaded OnLoaded;
+	FDelegateHandle PostLoadMapHandle;
+	FDelegateHandle TravelFailureHandle;
+};
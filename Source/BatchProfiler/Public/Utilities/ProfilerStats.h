@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_STATS_GROUP(TEXT("BatchProfiler"), STATGROUP_BatchProfiler, STATCAT_Advanced);
+
+/**
+ * Accumulates the time spent in batch profiler scopes so the plugin can report its own overhead.
+ * Only the outermost scope of each thread is counted, nested scopes are part of their parent.
+ */
+class BATCHPROFILER_API FProfilerOverhead
+{
+public:
+	struct BATCHPROFILER_API FScope
+	{
+		FScope();
+		~FScope();
+
+	private:
+		uint64 StartCycles;
+	};
+
+	static double GetSeconds();
+	static void Reset();
+};
+
+#if STATS
+#define BATCHPROFILER_STAT_SCOPE(Name) DECLARE_SCOPE_CYCLE_COUNTER(TEXT(#Name), STAT_BatchProfiler_##Name, STATGROUP_BatchProfiler)
+#else
+#define BATCHPROFILER_STAT_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE(BatchProfiler_##Name)
+#endif
+
+// Cycle stat (stat BatchProfiler), Insights CPU scope and overhead accounting of a plugin scope
+#define BATCHPROFILER_SCOPE(Name) \
+	const FProfilerOverhead::FScope PREPROCESSOR_JOIN(BatchProfilerOverheadScope_, __LINE__); \
+	BATCHPROFILER_STAT_SCOPE(Name)
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BatchProfilerSettings.h"
+
+/**
+ * Maps profiling trace channels to the identifiers registered by the engine
+ */
+class BATCHPROFILER_API FTraceChannels
+{
+public:
+	static FString GetChannelName(const EProfilingTraceChannel Channel);
+	static TArray<FString> GetRegisteredChannels();
+	static bool IsChannelRegistered(const FString& ChannelName);
+	static FString BuildChannelSet(const TArray<EProfilingTraceChannel>& Channels);
+};
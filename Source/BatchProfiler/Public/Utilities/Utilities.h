@@ -1,8 +1,13 @@
 #pragma once
 
+class UWorld;
+
 class FUtilities
 {
 public:
 	static void ExecuteCommand(const FString Cmd);
 	static void ShowNotification(const FString& Message, bool bIsSuccess, const float FadeOutDuration = 7.f);
+	static FString GetReportDirectory();
+	static bool SaveReport(const FString& ReportName, const FString& Contents);
+	static UWorld* GetGameWorld();
 };